@@ -0,0 +1,350 @@
+#ifndef ADAPTIVEENGINE_HPP_
+#define ADAPTIVEENGINE_HPP_
+
+#include "GeneticEngine.hpp"
+#include "GeneticPolicies.hpp"
+#include "TSP.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <time.h>
+
+/*
+ * Adaptive pursuit (Thierens, 2005) over a fixed set of arms. Every arm keeps a running
+ * estimate of its reward, pursue() moves the probability of the best estimated arm
+ * towards maxProbability and of every other arm towards minProbability, so no arm is
+ * ever abandoned and a change of the best arm is noticed.
+ */
+class AdaptivePursuit
+{
+public:
+    AdaptivePursuit(const unsigned numOfArms, const long double minProbability,
+            const long double learningRate, const long double pursuitRate)
+            : probabilities_(numOfArms, 1.0L / numOfArms), rewards_(numOfArms, 0.0L),
+              minProbability_ { std::min(minProbability, 1.0L / numOfArms) },
+              maxProbability_ { 1.0L - (numOfArms - 1) * minProbability_ },
+              learningRate_ { learningRate }, pursuitRate_ { pursuitRate }
+    {}
+
+    unsigned choose(RandomGenerator& randomGen) const
+    {
+        std::uniform_real_distribution<long double> distr(0, 1);
+        long double r = distr(randomGen);
+        for (auto arm = 0U; arm + 1 < probabilities_.size(); ++arm)
+        {
+            if (r < probabilities_[arm])
+            {
+                return arm;
+            }
+            r -= probabilities_[arm];
+        }
+        return probabilities_.size() - 1;
+    }
+
+    void reward(const unsigned arm, const long double reward)
+    {
+        rewards_[arm] += learningRate_ * (reward - rewards_[arm]);
+    }
+
+    void pursue()
+    {
+        const unsigned best = std::max_element(rewards_.begin(), rewards_.end())
+                - rewards_.begin();
+        for (auto arm = 0U; arm < probabilities_.size(); ++arm)
+        {
+            const long double target { arm == best ? maxProbability_ : minProbability_ };
+            probabilities_[arm] += pursuitRate_ * (target - probabilities_[arm]);
+        }
+    }
+
+    const std::vector<long double>& getProbabilities() const
+    {
+        return probabilities_;
+    }
+
+private:
+    std::vector<long double> probabilities_;
+    std::vector<long double> rewards_;
+    const long double minProbability_;
+    const long double maxProbability_;
+    const long double learningRate_;
+    const long double pursuitRate_;
+};
+
+struct AdaptiveParameters
+{
+    unsigned minPopulationSize_ = 20;
+    unsigned maxPopulationSize_ = 1000;
+    // Generations without a new best route after which the population grows by half
+    unsigned stagnationLimit_ = 20;
+    long double minProbability_ = 0.05;
+    long double learningRate_ = 0.3;
+    long double pursuitRate_ = 0.3;
+    // Rewards improvement per CPU second spent on a child instead of per child. Measured
+    // time steers the operator choice, so runs with it aren't reproducible for a seed.
+    bool perTime_ = false;
+};
+
+/*
+ * Generational genetic algorithm tuning itself while it runs, in place of fixed operators
+ * and parameters. Every child is bred by a crossover, a mutation and a mutation rate drawn
+ * from three adaptive pursuits, each of them rewarded with the child's improvement over
+ * the mean of its parents, or with perTime_ per CPU time of the engine's thread spent
+ * breeding and evaluating it. The population shrinks by a tenth, down to
+ * minPopulationSize_, in every generation finding a new best route and grows by half,
+ * up to maxPopulationSize_, with fresh random routes on stagnation.
+ *
+ * populationSize_ of GeneticParameters is the initial size and mutationProbability_ is
+ * unused. The budget is the number of children numOfGenerations_ generations
+ * of GeneticEngine would breed with the initial population.
+ */
+template<typename Distance, typename R = Route>
+class AdaptiveEngine
+{
+public:
+    using Result = BasicSolution<R>;
+    using Individual = BasicSolution<R>;
+    using Individuals = std::vector<Individual>;
+    using Routes = std::vector<R>;
+
+    // Arms of the pursuits
+    enum CrossoverArm { ORDER, PMX, NUM_OF_CROSSOVERS };
+    enum MutationArm { SWAP, INVERSION, NUM_OF_MUTATIONS };
+    static constexpr unsigned NUM_OF_RATES = 4;
+
+    AdaptiveEngine(Distance distance, const unsigned numOfCities,
+            const GeneticParameters& parameters,
+            const AdaptiveParameters& adaptive = AdaptiveParameters())
+            : distance_ { std::move(distance) }, numOfCities_ { numOfCities },
+              parameters_ { parameters }, adaptive_ { adaptive },
+              crossovers_ { NUM_OF_CROSSOVERS, adaptive.minProbability_,
+                      adaptive.learningRate_, adaptive.pursuitRate_ },
+              mutations_ { NUM_OF_MUTATIONS, adaptive.minProbability_,
+                      adaptive.learningRate_, adaptive.pursuitRate_ },
+              rates_ { NUM_OF_RATES, adaptive.minProbability_,
+                      adaptive.learningRate_, adaptive.pursuitRate_ }
+    {
+        // Selection needs two parents in the fitter half
+        adaptive_.minPopulationSize_ = std::max(adaptive_.minPopulationSize_, 4U);
+        adaptive_.maxPopulationSize_ = std::max(adaptive_.maxPopulationSize_,
+                adaptive_.minPopulationSize_);
+    }
+
+    Result run(RandomGenerator& randomGen, Routes routes = Routes(0))
+    {
+        Individuals population;
+        const unsigned initialSize = routes.empty() ?
+                std::max(parameters_.populationSize_, 4U) : routes.size();
+        if (routes.empty())
+        {
+            grow(population, initialSize, randomGen);
+        }
+        else
+        {
+            for (auto& route : routes)
+            {
+                const unsigned cost = distance_(route);
+                population.push_back({cost, std::move(route)});
+            }
+        }
+
+        numOfOffspring_ = 0U;
+        bestCost_ = fittest(population).cost_;
+        numOfStagnantGenerations_ = 0U;
+        const unsigned long long budget { static_cast<unsigned long long>(
+                parameters_.numOfGenerations_) * (initialSize - initialSize / 2) };
+        while (numOfOffspring_ < budget)
+        {
+            step(population, randomGen);
+            control(population, randomGen);
+        }
+        populationSize_ = population.size();
+        return fittest(population);
+    }
+
+    const std::vector<long double>& getCrossoverProbabilities() const
+    {
+        return crossovers_.getProbabilities();
+    }
+
+    const std::vector<long double>& getMutationProbabilities() const
+    {
+        return mutations_.getProbabilities();
+    }
+
+    const std::vector<long double>& getRateProbabilities() const
+    {
+        return rates_.getProbabilities();
+    }
+
+    // Mutation rate of every arm of the rate pursuit
+    static long double rateOf(const unsigned arm)
+    {
+        static const long double rates[NUM_OF_RATES] = { 0.01, 0.05, 0.2, 0.5 };
+        return rates[arm];
+    }
+
+    // Size of the population the last run ended with
+    unsigned getPopulationSize() const
+    {
+        return populationSize_;
+    }
+
+private:
+    // CPU time of the calling thread, time it spends preempted isn't charged to an arm
+    static long double cpuSeconds()
+    {
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return now.tv_sec + now.tv_nsec * 1e-9L;
+    }
+
+    // Improvement and time of the children bred by one arm in a generation
+    struct Credit
+    {
+        long double gain_ = 0.0;
+        long double seconds_ = 0.0;
+    };
+
+    void step(Individuals& population, RandomGenerator& randomGen)
+    {
+        replacement_.prepare(population);
+        offspring_.resize(replacement_.numOfOffspring(population.size()));
+        std::vector<Credit> crossoverCredits(NUM_OF_CROSSOVERS);
+        std::vector<Credit> mutationCredits(NUM_OF_MUTATIONS);
+        std::vector<Credit> rateCredits(NUM_OF_RATES);
+        std::uniform_real_distribution<long double> distr(0, 1);
+        for (auto& child : offspring_)
+        {
+            const auto parents = selection_(population, randomGen);
+            const unsigned crossover = crossovers_.choose(randomGen);
+            const unsigned mutation = mutations_.choose(randomGen);
+            const unsigned rate = rates_.choose(randomGen);
+            const long double start = adaptive_.perTime_ ? cpuSeconds() : 0.0L;
+
+            GeneticPolicies::RouteTraits<R>::resize(child.route_, numOfCities_);
+            const R& parent_a = population[parents.first].route_;
+            const R& parent_b = population[parents.second].route_;
+            if (crossover == ORDER)
+            {
+                order_(parent_a, parent_b, child.route_, randomGen);
+            }
+            else
+            {
+                pmx_(parent_a, parent_b, child.route_, randomGen);
+            }
+            if (distr(randomGen) < rateOf(rate))
+            {
+                if (mutation == SWAP)
+                {
+                    swap_(child.route_, randomGen);
+                }
+                else
+                {
+                    inversion_(child.route_, randomGen);
+                }
+            }
+            child.cost_ = distance_(child.route_);
+
+            const long double parentsCost { (static_cast<long double>(
+                    population[parents.first].cost_) + population[parents.second].cost_) / 2 };
+            const Credit credit { std::max(0.0L, parentsCost - child.cost_) / parentsCost,
+                    adaptive_.perTime_ ? cpuSeconds() - start : 1.0L };
+            for (auto* c : {&crossoverCredits[crossover], &mutationCredits[mutation],
+                    &rateCredits[rate]})
+            {
+                c->gain_ += credit.gain_;
+                c->seconds_ += credit.seconds_;
+            }
+        }
+        numOfOffspring_ += offspring_.size();
+        replacement_.replace(population, offspring_);
+
+        reward(crossovers_, crossoverCredits);
+        reward(mutations_, mutationCredits);
+        reward(rates_, rateCredits);
+    }
+
+    static void reward(AdaptivePursuit& pursuit, const std::vector<Credit>& credits)
+    {
+        for (auto arm = 0U; arm < credits.size(); ++arm)
+        {
+            if (credits[arm].seconds_ > 0.0)
+            {
+                pursuit.reward(arm, credits[arm].gain_ / credits[arm].seconds_);
+            }
+        }
+        pursuit.pursue();
+    }
+
+    void control(Individuals& population, RandomGenerator& randomGen)
+    {
+        const unsigned best = fittest(population).cost_;
+        if (best < bestCost_)
+        {
+            bestCost_ = best;
+            numOfStagnantGenerations_ = 0U;
+            // Progress comes easily, cheaper generations get more of them out of the budget
+            const unsigned size = std::max<unsigned>(adaptive_.minPopulationSize_,
+                    population.size() - population.size() / 10);
+            if (size < population.size())
+            {
+                std::nth_element(population.begin(), population.begin() + size,
+                        population.end(), [](const Individual& lhs, const Individual& rhs)
+                        {
+                            return lhs.cost_ < rhs.cost_;
+                        });
+                population.resize(size);
+            }
+        }
+        else if (++numOfStagnantGenerations_ >= adaptive_.stagnationLimit_)
+        {
+            numOfStagnantGenerations_ = 0U;
+            const unsigned size = std::min<unsigned>(adaptive_.maxPopulationSize_,
+                    population.size() + population.size() / 2);
+            numOfOffspring_ += size - population.size();
+            grow(population, size, randomGen);
+        }
+    }
+
+    void grow(Individuals& population, const unsigned size, RandomGenerator& randomGen) const
+    {
+        R route { GeneticPolicies::RouteTraits<R>::identity(numOfCities_) };
+        while (population.size() < size)
+        {
+            std::shuffle(route.begin(), route.end(), randomGen);
+            population.push_back({distance_(route), route});
+        }
+    }
+
+    static const Individual& fittest(const Individuals& population)
+    {
+        return *std::min_element(population.begin(), population.end(),
+                [](const Individual& lhs, const Individual& rhs){return lhs.cost_ < rhs.cost_;});
+    }
+
+    Distance distance_;
+    const unsigned numOfCities_;
+    const GeneticParameters parameters_;
+    AdaptiveParameters adaptive_;
+    AdaptivePursuit crossovers_;
+    AdaptivePursuit mutations_;
+    AdaptivePursuit rates_;
+    GeneticPolicies::TruncationSelection selection_;
+    GeneticPolicies::OrderCrossover order_;
+    GeneticPolicies::PartiallyMappedCrossover pmx_;
+    GeneticPolicies::SwapMutation swap_;
+    GeneticPolicies::InversionMutation inversion_;
+    GeneticPolicies::ReplaceWorstHalf replacement_;
+    Individuals offspring_;
+    unsigned long long numOfOffspring_ = 0U;
+    unsigned bestCost_ = std::numeric_limits<unsigned>::max();
+    unsigned numOfStagnantGenerations_ = 0U;
+    unsigned populationSize_ = 0U;
+};
+
+#endif /* ADAPTIVEENGINE_HPP_ */
@@ -0,0 +1,89 @@
+#include "AdaptiveEngine.hpp"
+#include "TSP.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+
+using Engine = AdaptiveEngine<GeneticPolicies::MatrixDistance>;
+
+}
+
+TEST(AdaptivePursuit, pursuesTheBestRewardedArm)
+{
+    AdaptivePursuit pursuit(3, 0.1, 0.5, 0.5);
+    for (auto i = 0U; i < 50; ++i)
+    {
+        pursuit.reward(0, 0.1);
+        pursuit.reward(2, 1.0);
+        pursuit.pursue();
+    }
+    const auto& p = pursuit.getProbabilities();
+    ASSERT_NEAR(0.1, p[0], 1e-6);
+    ASSERT_NEAR(0.1, p[1], 1e-6);
+    ASSERT_NEAR(0.8, p[2], 1e-6);
+
+    RandomGenerator randomGen { 3 };
+    unsigned numOfBest = 0U;
+    for (auto i = 0U; i < 1000; ++i)
+    {
+        numOfBest += pursuit.choose(randomGen) == 2;
+    }
+    ASSERT_NEAR(800, numOfBest, 60);
+}
+
+TEST(AdaptiveEngine, findsAValidReproducibleRoute)
+{
+    const TSP tsp("/home/dec/studia/sem6/zwsisk/swiss42.tsp");
+    Solution solutions[2];
+    for (auto& s : solutions)
+    {
+        RandomGenerator randomGen { 11 };
+        Engine engine(GeneticPolicies::MatrixDistance { tsp.getDistances() },
+                tsp.getNumOfCities(), { 30, 0.0, 100 });
+        s = engine.run(randomGen);
+        const auto& p = engine.getCrossoverProbabilities();
+        ASSERT_NEAR(1.0, std::accumulate(p.begin(), p.end(), 0.0L), 1e-9);
+    }
+    ASSERT_EQ(solutions[0].route_, solutions[1].route_);
+    ASSERT_EQ(tsp.calcCostOfRoute(solutions[0].route_), solutions[0].cost_);
+    Route expected(tsp.getNumOfCities());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(solutions[0].route_.begin(), solutions[0].route_.end());
+    ASSERT_EQ(expected, solutions[0].route_);
+}
+
+TEST(AdaptiveEngine, growsPopulationOnStagnation)
+{
+    // Every route of 4 cities is found at once, nothing improves afterwards
+    const TSP tsp("/home/dec/studia/sem6/zwsisk/graph_full_matrix.txt");
+    AdaptiveParameters adaptive;
+    adaptive.minPopulationSize_ = 8;
+    adaptive.maxPopulationSize_ = 64;
+    adaptive.stagnationLimit_ = 1;
+    Engine engine(GeneticPolicies::MatrixDistance { tsp.getDistances() },
+            tsp.getNumOfCities(), { 16, 0.0, 50 }, adaptive);
+    RandomGenerator randomGen { 2 };
+    engine.run(randomGen);
+    ASSERT_EQ(64U, engine.getPopulationSize());
+}
+
+TEST(AdaptiveEngine, creditsOperatorsPerCpuTimeThroughTsp)
+{
+    const TSP tsp("/home/dec/studia/sem6/zwsisk/swiss42.tsp");
+    AdaptiveParameters adaptive;
+    adaptive.perTime_ = true;
+    RandomGenerator randomGen { 5 };
+    const Solution s { tsp.genetic_adaptive(30, 50, randomGen, adaptive) };
+    ASSERT_EQ(tsp.calcCostOfRoute(s.route_), s.cost_);
+    Route route { s.route_ };
+    std::sort(route.begin(), route.end());
+    Route expected(tsp.getNumOfCities());
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(expected, route);
+}
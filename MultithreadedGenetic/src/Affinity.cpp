@@ -0,0 +1,185 @@
+#include "Affinity.hpp"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace Affinity
+{
+
+std::vector<unsigned> availableCpus()
+{
+    std::vector<unsigned> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (auto cpu = 0U; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (cpus.empty())
+    {
+        for (auto cpu = 0U; cpu < std::thread::hardware_concurrency(); ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool pinCurrentThreadToCpu(const unsigned cpu)
+{
+    if (cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+unsigned Topology::getNumOfNodes() const
+{
+    return cpusOfNode_.size();
+}
+
+unsigned Topology::nodeOf(const unsigned cpu) const
+{
+    for (auto node = 0U; node < cpusOfNode_.size(); ++node)
+    {
+        const auto& cpus = cpusOfNode_[node];
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end())
+        {
+            return node;
+        }
+    }
+    return 0U;
+}
+
+std::vector<unsigned> parseCpuList(const std::string& cpuList)
+{
+    std::vector<unsigned> cpus;
+    std::istringstream ss(cpuList);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+        const auto dash = range.find('-');
+        try
+        {
+            const unsigned first = std::stoul(range.substr(0, dash));
+            const unsigned last = dash == std::string::npos ?
+                    first : std::stoul(range.substr(dash + 1));
+            for (auto cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        catch (const std::logic_error&)
+        {
+            // blank or malformed entry, nothing to add
+        }
+    }
+    return cpus;
+}
+
+Topology detectTopology(const std::string& sysNodePath /*= "/sys/devices/system/node"*/)
+{
+    const std::vector<unsigned> available { availableCpus() };
+    std::vector<std::pair<unsigned, std::vector<unsigned>>> nodes;
+
+    if (DIR* dir = opendir(sysNodePath.c_str()))
+    {
+        while (const dirent* entry = readdir(dir))
+        {
+            const std::string name { entry->d_name };
+            if (name.compare(0, 4, "node") || name.size() == 4
+                    || !std::all_of(name.begin() + 4, name.end(), ::isdigit))
+            {
+                continue;
+            }
+            std::ifstream file(sysNodePath + "/" + name + "/cpulist");
+            std::string cpuList;
+            std::getline(file, cpuList);
+            std::vector<unsigned> cpus;
+            for (const auto cpu : parseCpuList(cpuList))
+            {
+                if (std::binary_search(available.begin(), available.end(), cpu))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty())
+            {
+                nodes.emplace_back(std::stoul(name.substr(4)), std::move(cpus));
+            }
+        }
+        closedir(dir);
+    }
+
+    Topology topology;
+    std::sort(nodes.begin(), nodes.end());
+    for (auto& node : nodes)
+    {
+        topology.cpusOfNode_.push_back(std::move(node.second));
+    }
+    if (topology.cpusOfNode_.empty())
+    {
+        topology.cpusOfNode_.push_back(available);
+    }
+    return topology;
+}
+
+std::vector<unsigned> assignCpus(const Topology& topology, const Placement placement,
+        const unsigned numOfWorkers)
+{
+    std::vector<unsigned> order;
+    if (placement == Placement::Compact)
+    {
+        for (const auto& cpus : topology.cpusOfNode_)
+        {
+            order.insert(order.end(), cpus.begin(), cpus.end());
+        }
+    }
+    else if (placement == Placement::Scatter)
+    {
+        for (auto i = 0U; ; ++i)
+        {
+            bool added = false;
+            for (const auto& cpus : topology.cpusOfNode_)
+            {
+                if (i < cpus.size())
+                {
+                    order.push_back(cpus[i]);
+                    added = true;
+                }
+            }
+            if (!added)
+            {
+                break;
+            }
+        }
+    }
+
+    std::vector<unsigned> assigned;
+    for (auto worker = 0U; !order.empty() && worker < numOfWorkers; ++worker)
+    {
+        assigned.push_back(order[worker % order.size()]);
+    }
+    return assigned;
+}
+
+}
@@ -0,0 +1,53 @@
+#ifndef AFFINITY_HPP_
+#define AFFINITY_HPP_
+
+#include <string>
+#include <vector>
+
+namespace Affinity
+{
+
+// CPUs the process is allowed to run on, in ascending order
+std::vector<unsigned> availableCpus();
+
+// Returns false if the thread couldn't be pinned (e.g. CPU not available)
+bool pinCurrentThreadToCpu(const unsigned cpu);
+
+// Available CPUs grouped by NUMA node
+struct Topology
+{
+    std::vector<std::vector<unsigned>> cpusOfNode_;
+
+    unsigned getNumOfNodes() const;
+    // Node of given CPU, 0 if unknown
+    unsigned nodeOf(const unsigned cpu) const;
+};
+
+// Reads /sys/devices/system/node, a single node holding every available CPU if it's missing
+Topology detectTopology(const std::string& sysNodePath = "/sys/devices/system/node");
+
+// Parses cpulist format, e.g. "0-3,8,10-11"
+std::vector<unsigned> parseCpuList(const std::string& cpuList);
+
+enum class Placement
+{
+    None,    // leave threads to the scheduler
+    Compact, // fill the CPUs of one node before moving to the next one
+    Scatter  // round-robin over nodes
+};
+
+struct PlacementPolicy
+{
+    Placement placement_ = Placement::None;
+    // Give every NUMA node its own copy of the distance matrix
+    bool replicateDistances_ = false;
+};
+
+// CPU for each of numOfWorkers workers, wraps around when there are more workers than CPUs.
+// Empty for Placement::None.
+std::vector<unsigned> assignCpus(const Topology& topology, const Placement placement,
+        const unsigned numOfWorkers);
+
+}
+
+#endif /* AFFINITY_HPP_ */
@@ -0,0 +1,32 @@
+#include "Affinity.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::ElementsAre;
+
+TEST(Affinity, parsesCpuList)
+{
+    ASSERT_THAT(Affinity::parseCpuList("0-3,8,10-11\n"), ElementsAre(0, 1, 2, 3, 8, 10, 11));
+    ASSERT_TRUE(Affinity::parseCpuList("").empty());
+}
+
+TEST(Affinity, fallsBackToSingleNodeWithoutSysfs)
+{
+    const Affinity::Topology topology { Affinity::detectTopology("/witam") };
+    ASSERT_EQ(1, topology.getNumOfNodes());
+    ASSERT_EQ(Affinity::availableCpus(), topology.cpusOfNode_[0]);
+}
+
+TEST(Affinity, assignsCpusCompactAndScattered)
+{
+    Affinity::Topology topology;
+    topology.cpusOfNode_ = { {0, 1}, {2, 3} };
+    ASSERT_EQ(0, topology.nodeOf(1));
+    ASSERT_EQ(1, topology.nodeOf(3));
+    ASSERT_THAT(Affinity::assignCpus(topology, Affinity::Placement::Compact, 5),
+            ElementsAre(0, 1, 2, 3, 0));
+    ASSERT_THAT(Affinity::assignCpus(topology, Affinity::Placement::Scatter, 5),
+            ElementsAre(0, 2, 1, 3, 0));
+    ASSERT_TRUE(Affinity::assignCpus(topology, Affinity::Placement::None, 5).empty());
+}
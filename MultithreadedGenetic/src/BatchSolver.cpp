@@ -0,0 +1,344 @@
+#include "BatchSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace BatchSolver
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+struct Result
+{
+    Job job_;
+    unsigned numOfCities_ = 0U;
+    unsigned numOfIslands_ = 0U;
+    Solution solution_;
+    long double millis_ = 0.0;
+    std::string error_;
+};
+
+std::string escape(const std::string& text)
+{
+    std::string escaped;
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeJsonLine(std::ostream& os, const Result& result, const bool writeRoute)
+{
+    os << "{\"index\":" << result.job_.index_ << ",\"name\":\"" << escape(result.job_.name_)
+            << "\",\"path\":\"" << escape(result.job_.path_) << '"';
+    if (!result.error_.empty())
+    {
+        os << ",\"error\":\"" << escape(result.error_) << "\"}\n";
+        return;
+    }
+    os << ",\"cities\":" << result.numOfCities_ << ",\"islands\":" << result.numOfIslands_
+            << ",\"cost\":" << result.solution_.cost_ << ",\"millis\":" << result.millis_;
+    if (writeRoute)
+    {
+        os << ",\"route\":[";
+        for (auto i = 0U; i < result.solution_.route_.size(); ++i)
+        {
+            os << (i ? "," : "") << result.solution_.route_[i];
+        }
+        os << ']';
+    }
+    os << "}\n";
+}
+
+// Shared by the tasks of one manifest: output, summary and the bound on jobs in flight
+class Batch
+{
+public:
+    Batch(std::ostream& os, const Settings& settings, const unsigned maxNumOfJobsInFlight)
+            : os_ { os }, settings_ { settings }, maxNumOfJobsInFlight_ { maxNumOfJobsInFlight }
+    {}
+
+    void acquire()
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_.wait(lock, [this](){return numOfJobsInFlight_ < maxNumOfJobsInFlight_;});
+        ++numOfJobsInFlight_;
+    }
+
+    void finish(const Result& result)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            writeJsonLine(os_, result, settings_.writeRoutes_);
+            ++summary_.numOfJobs_;
+            summary_.numOfFailed_ += !result.error_.empty();
+            --numOfJobsInFlight_;
+            // Under the lock, wait() returning may destroy the batch right after it's released
+            cv_.notify_all();
+        }
+    }
+
+    Summary wait()
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_.wait(lock, [this](){return numOfJobsInFlight_ == 0;});
+        os_.flush();
+        return summary_;
+    }
+
+    const Settings& getSettings() const
+    {
+        return settings_;
+    }
+
+private:
+    std::ostream& os_;
+    const Settings settings_;
+    const unsigned maxNumOfJobsInFlight_;
+    unsigned numOfJobsInFlight_ = 0U;
+    Summary summary_;
+    std::mutex m_;
+    std::condition_variable cv_;
+};
+
+// A big instance solved by independent island tasks, the last one to finish breeds
+// the final population from the best routes of all islands
+struct Islands
+{
+    Result result_;
+    Clock::time_point start_;
+    std::shared_ptr<const TSP> tsp_;
+    std::vector<std::uint64_t> seeds_;
+    std::uint64_t mergeSeed_ = 0U;
+    Population bests_;
+    unsigned numOfRemaining_ = 0U;
+    std::mutex m_;
+};
+
+long double millisSince(const Clock::time_point start)
+{
+    return std::chrono::duration<long double, std::milli>(Clock::now() - start).count();
+}
+
+void merge(Islands& islands)
+{
+    const GeneticParameters& p = islands.result_.job_.parameters_;
+    Population population { std::move(islands.bests_) };
+    RandomGenerator mergeGen { islands.mergeSeed_ };
+    if (population.size() < p.populationSize_)
+    {
+        Population fresh { islands.tsp_->generateInitPopulation(
+                p.populationSize_ - population.size(), mergeGen) };
+        std::move(fresh.begin(), fresh.end(), std::back_inserter(population));
+    }
+    islands.result_.solution_ = islands.tsp_->genetic(population.size(),
+            p.mutationProbability_, p.numOfGenerations_, mergeGen, std::move(population));
+}
+
+void solveIsland(Batch& batch, const std::shared_ptr<Islands>& islands, const unsigned island)
+{
+    const GeneticParameters& p = islands->result_.job_.parameters_;
+    RandomGenerator randomGen { islands->seeds_[island] };
+    Solution best;
+    std::string error;
+    try
+    {
+        best = islands->tsp_->genetic(p.populationSize_, p.mutationProbability_,
+                p.numOfGenerations_, randomGen);
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+    }
+    {
+        std::lock_guard<std::mutex> lock(islands->m_);
+        // Indexed by island, so the merged population doesn't depend on completion order
+        islands->bests_[island] = std::move(best.route_);
+        if (!error.empty())
+        {
+            islands->result_.error_ = std::move(error);
+        }
+        if (--islands->numOfRemaining_ > 0)
+        {
+            return;
+        }
+    }
+
+    if (islands->result_.error_.empty())
+    {
+        try
+        {
+            merge(*islands);
+        }
+        catch (const std::exception& e)
+        {
+            islands->result_.error_ = e.what();
+        }
+    }
+    islands->result_.millis_ = millisSince(islands->start_);
+    batch.finish(islands->result_);
+}
+
+void solve(Batch& batch, ThreadPool& pool, const Job& job)
+{
+    const auto start = Clock::now();
+    Result result;
+    result.job_ = job;
+    std::shared_ptr<const TSP> tsp;
+    try
+    {
+        tsp = std::make_shared<const TSP>(job.path_);
+        result.numOfCities_ = tsp->getNumOfCities();
+        result.numOfIslands_ = numOfIslandsFor(result.numOfCities_, batch.getSettings(),
+                pool.getNumOfThreads());
+        if (result.numOfIslands_ == 1)
+        {
+            RandomGenerator randomGen { job.seed_ };
+            const GeneticParameters& p = job.parameters_;
+            result.solution_ = tsp->genetic(p.populationSize_, p.mutationProbability_,
+                    p.numOfGenerations_, randomGen);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        result.error_ = e.what();
+    }
+    if (result.numOfIslands_ <= 1 || !result.error_.empty())
+    {
+        result.millis_ = millisSince(start);
+        batch.finish(result);
+        return;
+    }
+
+    RandomGenerator randomGen { job.seed_ };
+    auto islands = std::make_shared<Islands>();
+    islands->result_ = std::move(result);
+    islands->start_ = start;
+    islands->tsp_ = std::move(tsp);
+    for (auto i = 0U; i < islands->result_.numOfIslands_; ++i)
+    {
+        islands->seeds_.push_back(randomGen());
+    }
+    islands->mergeSeed_ = randomGen();
+    islands->bests_.resize(islands->result_.numOfIslands_);
+    islands->numOfRemaining_ = islands->result_.numOfIslands_;
+    // Queued behind the jobs already submitted, a task never waits for another one
+    for (auto i = 0U; i < islands->result_.numOfIslands_; ++i)
+    {
+        pool.submit([&batch, islands, i](){solveIsland(batch, islands, i);});
+    }
+}
+
+}
+
+long double Summary::jobsPerSecond() const
+{
+    return seconds_ > 0.0 ? numOfJobs_ / seconds_ : 0.0;
+}
+
+bool parseJob(const std::string& line, const std::string& directory, const Settings& settings,
+        const unsigned index, Job& job)
+{
+    std::istringstream ss(line);
+    std::string path;
+    if (!(ss >> path) || path[0] == '#')
+    {
+        return false;
+    }
+
+    job.index_ = index;
+    job.path_ = path[0] == '/' ? path : directory + "/" + path;
+    const auto slash = path.rfind('/');
+    const std::string fileName { slash == std::string::npos ? path : path.substr(slash + 1) };
+    job.name_ = fileName.substr(0, fileName.rfind('.'));
+    job.parameters_ = settings.parameters_;
+    job.seed_ = settings.seed_ + index;
+
+    GeneticParameters parameters;
+    if (ss >> parameters.populationSize_)
+    {
+        if (!(ss >> parameters.mutationProbability_ >> parameters.numOfGenerations_)
+                || parameters.populationSize_ == 0)
+        {
+            throw std::runtime_error { " * Malformed manifest line: " + line + " * " };
+        }
+        job.parameters_ = parameters;
+        std::uint64_t seed = 0U;
+        if (ss >> seed)
+        {
+            job.seed_ = seed;
+        }
+    }
+    return true;
+}
+
+unsigned numOfIslandsFor(const unsigned numOfCities, const Settings& settings,
+        const unsigned numOfThreads)
+{
+    const unsigned wanted { settings.maxNumOfCitiesPerIsland_ ?
+            numOfCities / settings.maxNumOfCitiesPerIsland_ : 1U };
+    return std::max(1U, std::min({wanted, settings.maxNumOfIslands_, numOfThreads}));
+}
+
+Summary run(std::istream& manifest, const std::string& directory, std::ostream& os,
+        const Settings& settings, ThreadPool& pool)
+{
+    const auto start = Clock::now();
+    Batch batch(os, settings, settings.maxNumOfJobsInFlight_ ?
+            settings.maxNumOfJobsInFlight_ : 2 * pool.getNumOfThreads());
+
+    std::string line;
+    unsigned index = 0U;
+    while (std::getline(manifest, line))
+    {
+        Job job;
+        try
+        {
+            if (!parseJob(line, directory, settings, index, job))
+            {
+                continue;
+            }
+        }
+        catch (...)
+        {
+            // Tasks already submitted refer to batch
+            batch.wait();
+            throw;
+        }
+        ++index;
+        batch.acquire();
+        pool.submit([&batch, &pool, job](){solve(batch, pool, job);});
+    }
+
+    Summary summary { batch.wait() };
+    summary.seconds_ = std::chrono::duration<long double>(Clock::now() - start).count();
+    return summary;
+}
+
+std::string directoryOf(const std::string& path)
+{
+    const auto slash = path.rfind('/');
+    if (slash == std::string::npos)
+    {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+}
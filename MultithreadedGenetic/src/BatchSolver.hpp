@@ -0,0 +1,74 @@
+#ifndef BATCHSOLVER_HPP_
+#define BATCHSOLVER_HPP_
+
+#include "GeneticEngine.hpp"
+#include "ThreadPool.hpp"
+#include "TSP.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/*
+ * Solves many independent instances listed in a manifest on one thread pool, optimising
+ * the number of instances solved per second rather than the latency of any of them.
+ * Instances are loaded by the pool tasks as the manifest is read, and at most
+ * maxNumOfJobsInFlight_ of them are in memory at once. Small instances are solved
+ * by a single task, bigger ones are split into islands, each island being a separate task.
+ * Results are written as JSON lines in completion order.
+ *
+ * A manifest line is
+ *   <path> [populationSize mutationProbability numOfGenerations [seed]]
+ * Relative paths are relative to the manifest's directory, lines starting with '#'
+ * are comments.
+ */
+namespace BatchSolver
+{
+
+struct Job
+{
+    unsigned index_ = 0U;
+    std::string name_;
+    std::string path_;
+    GeneticParameters parameters_;
+    std::uint64_t seed_ = 0U;
+};
+
+struct Settings
+{
+    GeneticParameters parameters_;             // for jobs that don't set their own
+    std::uint64_t seed_ = 0U;                  // job i without its own seed uses seed_ + i
+    unsigned maxNumOfCitiesPerIsland_ = 200;   // bigger instances get more islands
+    unsigned maxNumOfIslands_ = 4;
+    unsigned maxNumOfJobsInFlight_ = 0U;       // 0 means twice the number of pool threads
+    bool writeRoutes_ = true;
+};
+
+struct Summary
+{
+    unsigned numOfJobs_ = 0U;
+    unsigned numOfFailed_ = 0U;
+    long double seconds_ = 0.0;
+
+    long double jobsPerSecond() const;
+};
+
+// False for blank and comment lines, throws std::runtime_error on malformed ones
+bool parseJob(const std::string& line, const std::string& directory, const Settings& settings,
+        const unsigned index, Job& job);
+
+// One island per maxNumOfCitiesPerIsland_ cities, bounded by the settings and the pool
+unsigned numOfIslandsFor(const unsigned numOfCities, const Settings& settings,
+        const unsigned numOfThreads);
+
+// Blocks until every job of the manifest is written, so it must not run on a pool thread.
+// A job whose instance can't be loaded is reported with an "error" field.
+Summary run(std::istream& manifest, const std::string& directory, std::ostream& os,
+        const Settings& settings, ThreadPool& pool);
+
+// Directory part of a path, "." if there is none
+std::string directoryOf(const std::string& path);
+
+}
+
+#endif /* BATCHSOLVER_HPP_ */
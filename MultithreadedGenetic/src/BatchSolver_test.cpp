@@ -0,0 +1,98 @@
+#include "BatchSolver.hpp"
+#include "ThreadPool.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using testing::HasSubstr;
+
+namespace
+{
+
+std::vector<std::string> lines(const std::string& text)
+{
+    std::istringstream ss(text);
+    std::vector<std::string> result;
+    std::string line;
+    while (std::getline(ss, line))
+    {
+        result.push_back(line);
+    }
+    return result;
+}
+
+}
+
+TEST(BatchSolver, parsesManifestLines)
+{
+    BatchSolver::Settings settings;
+    settings.seed_ = 100;
+    BatchSolver::Job job;
+    ASSERT_FALSE(BatchSolver::parseJob("", "/data", settings, 0, job));
+    ASSERT_FALSE(BatchSolver::parseJob("  # comment", "/data", settings, 0, job));
+
+    ASSERT_TRUE(BatchSolver::parseJob("tsp/swiss42.tsp", "/data", settings, 3, job));
+    ASSERT_EQ("swiss42", job.name_);
+    ASSERT_EQ("/data/tsp/swiss42.tsp", job.path_);
+    ASSERT_EQ(103U, job.seed_);
+    ASSERT_EQ(settings.parameters_.populationSize_, job.parameters_.populationSize_);
+
+    ASSERT_TRUE(BatchSolver::parseJob("/abs/a.tsp 20 0.5 30 7", "/data", settings, 3, job));
+    ASSERT_EQ("/abs/a.tsp", job.path_);
+    ASSERT_EQ(20U, job.parameters_.populationSize_);
+    ASSERT_EQ(30U, job.parameters_.numOfGenerations_);
+    ASSERT_EQ(7U, job.seed_);
+
+    ASSERT_THROW(BatchSolver::parseJob("a.tsp 20", "/data", settings, 0, job),
+            std::runtime_error);
+    ASSERT_EQ(".", BatchSolver::directoryOf("manifest.txt"));
+    ASSERT_EQ("/data/sets", BatchSolver::directoryOf("/data/sets/manifest.txt"));
+}
+
+TEST(BatchSolver, givesBigInstancesMoreIslands)
+{
+    BatchSolver::Settings settings;
+    ASSERT_EQ(1U, BatchSolver::numOfIslandsFor(42, settings, 8));
+    ASSERT_EQ(2U, BatchSolver::numOfIslandsFor(561, settings, 8));
+    ASSERT_EQ(4U, BatchSolver::numOfIslandsFor(5000, settings, 8));
+    ASSERT_EQ(3U, BatchSolver::numOfIslandsFor(5000, settings, 3));
+}
+
+TEST(BatchSolver, writesOneLinePerInstance)
+{
+    BatchSolver::Settings settings;
+    settings.parameters_ = { 20, 0.1, 20 };
+    settings.maxNumOfCitiesPerIsland_ = 10;
+    const std::string manifest { "graph_full_matrix.txt\n# skipped\nswiss42.tsp\nmissing.tsp\n" };
+
+    for (const unsigned numOfThreads : {1U, 3U})
+    {
+        std::istringstream in(manifest);
+        std::ostringstream out;
+        ThreadPool pool(numOfThreads);
+        const BatchSolver::Summary summary { BatchSolver::run(in,
+                "/home/dec/studia/sem6/zwsisk", out, settings, pool) };
+        ASSERT_EQ(3U, summary.numOfJobs_);
+        ASSERT_EQ(1U, summary.numOfFailed_);
+
+        const auto results = lines(out.str());
+        ASSERT_EQ(3U, results.size());
+        for (const auto& result : results)
+        {
+            if (result.find("\"swiss42\"") != std::string::npos)
+            {
+                ASSERT_THAT(result, HasSubstr("\"cities\":42"));
+                ASSERT_THAT(result, HasSubstr("\"islands\":" + std::to_string(numOfThreads)));
+            }
+            if (result.find("\"missing\"") != std::string::npos)
+            {
+                ASSERT_THAT(result, HasSubstr("\"error\""));
+            }
+        }
+    }
+}
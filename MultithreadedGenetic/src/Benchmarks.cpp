@@ -0,0 +1,486 @@
+#include "Checkpoint.hpp"
+#include "DynamicTSP.hpp"
+#include "GeneticConfig.hpp"
+#include "GeneticEngine.hpp"
+#include "InstanceGenerator.hpp"
+#include "SmallTSP.hpp"
+#include "TSP.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Benchmarks of the solver kernels and of the whole solvers.
+ * Run with "MultithreadedGenetic --benchmark [google benchmark flags]", e.g.
+ *   --benchmark_repetitions=20 --benchmark_filter=genetic
+ * Percentiles are reported next to mean/median/stddev whenever repetitions > 1.
+ * Instances are read from ZWSISK_DATA_DIR (defaults to the project directory).
+ */
+
+namespace
+{
+
+constexpr unsigned POPULATION_SIZE = 150;
+constexpr long double MUTATION_PROBABILITY = 0.01;
+constexpr unsigned NUM_OF_GENERATIONS = 20;
+constexpr unsigned MIN_COST = 1;
+constexpr unsigned MAX_COST = 1000;
+constexpr std::uint64_t SEED = 42;
+
+enum Instance
+{
+    SWISS42, PA561, SYNTHETIC_1K, SYNTHETIC_5K, NUM_OF_INSTANCES
+};
+
+std::string dataDir()
+{
+    const char* dir = std::getenv("ZWSISK_DATA_DIR");
+    return dir ? std::string { dir } + "/" : "/home/dec/studia/sem6/zwsisk/";
+}
+
+std::string instanceName(const int instance)
+{
+    switch (instance)
+    {
+    case SWISS42: return "swiss42";
+    case PA561: return "pa561";
+    case SYNTHETIC_1K: return "synthetic1000";
+    default: return "synthetic5000";
+    }
+}
+
+// Synthetic instances are uniform Euclidean ones, the same in every run
+std::unique_ptr<TSP> syntheticInstance(const unsigned numOfCities)
+{
+    InstanceGenerator::Settings settings;
+    settings.numOfCities_ = numOfCities;
+    settings.seed_ = SEED;
+    return std::make_unique<TSP>(InstanceGenerator::generate(settings));
+}
+
+std::unique_ptr<TSP> loadInstance(const int instance)
+{
+    switch (instance)
+    {
+    case SWISS42: return std::make_unique<TSP>(dataDir() + "swiss42.tsp");
+    case PA561: return std::make_unique<TSP>(dataDir() + "pa561.tsp");
+    case SYNTHETIC_1K: return syntheticInstance(1000);
+    default: return syntheticInstance(5000);
+    }
+}
+
+// Instances are loaded once and shared by every benchmark and benchmark thread
+const TSP& getInstance(const int instance)
+{
+    static std::mutex m;
+    static std::map<int, std::unique_ptr<TSP>> instances;
+    std::lock_guard<std::mutex> lock(m);
+    auto& tsp = instances[instance];
+    if (!tsp)
+    {
+        tsp = loadInstance(instance);
+    }
+    return *tsp;
+}
+
+double percentile(const std::vector<double>& v, const double p)
+{
+    std::vector<double> sorted(v);
+    std::sort(sorted.begin(), sorted.end());
+    const auto idx = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[idx];
+}
+
+void percentiles(benchmark::internal::Benchmark* b)
+{
+    b->ComputeStatistics("p50", [](const std::vector<double>& v){return percentile(v, 0.50);});
+    b->ComputeStatistics("p90", [](const std::vector<double>& v){return percentile(v, 0.90);});
+    b->ComputeStatistics("p99", [](const std::vector<double>& v){return percentile(v, 0.99);});
+}
+
+void allInstances(benchmark::internal::Benchmark* b)
+{
+    percentiles(b);
+    b->DenseRange(0, NUM_OF_INSTANCES - 1);
+    b->ThreadRange(1, std::max(1U, std::thread::hardware_concurrency()));
+}
+
+void instancesAndThreads(benchmark::internal::Benchmark* b)
+{
+    percentiles(b);
+    b->ArgNames({"instance", "threads"});
+    for (int instance = 0; instance < NUM_OF_INSTANCES; ++instance)
+    {
+        for (unsigned threads = 1; threads < 2 * std::thread::hardware_concurrency(); threads *= 2)
+        {
+            b->Args({instance, static_cast<int>(threads)});
+        }
+    }
+    b->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+Route randomRoute(const unsigned numOfCities, RandomGenerator& randomGen)
+{
+    Route route(numOfCities);
+    std::iota(route.begin(), route.end(), 0);
+    std::shuffle(route.begin(), route.end(), randomGen);
+    return route;
+}
+
+void BM_calcCostOfRoute(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED + state.thread_index() };
+    const Route route { randomRoute(tsp.getNumOfCities(), randomGen) };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tsp.calcCostOfRoute(route));
+    }
+    state.SetItemsProcessed(state.iterations() * tsp.getNumOfCities());
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK(BM_calcCostOfRoute)->Apply(allInstances);
+
+template<typename Crossover>
+void BM_crossover(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED + state.thread_index() };
+    const Route parent_a { randomRoute(tsp.getNumOfCities(), randomGen) };
+    const Route parent_b { randomRoute(tsp.getNumOfCities(), randomGen) };
+    Route offspring(tsp.getNumOfCities());
+    Crossover crossover;
+    for (auto _ : state)
+    {
+        crossover(parent_a, parent_b, offspring, randomGen);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK_TEMPLATE(BM_crossover, GeneticPolicies::OrderCrossover)->Apply(allInstances);
+BENCHMARK_TEMPLATE(BM_crossover, GeneticPolicies::PartiallyMappedCrossover)->Apply(allInstances);
+
+template<typename Mutation>
+void BM_mutate(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED + state.thread_index() };
+    Route route { randomRoute(tsp.getNumOfCities(), randomGen) };
+    Mutation mutation;
+    for (auto _ : state)
+    {
+        mutation(route, randomGen);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK_TEMPLATE(BM_mutate, GeneticPolicies::SwapMutation)->Apply(allInstances);
+BENCHMARK_TEMPLATE(BM_mutate, GeneticPolicies::InversionMutation)->Apply(allInstances);
+
+template<typename Selection>
+void BM_selection(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED + state.thread_index() };
+    DefaultGeneticEngine engine(GeneticPolicies::MatrixDistance { tsp.getDistances() },
+            tsp.getNumOfCities(), { POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS });
+    DefaultGeneticEngine::Individuals population { engine.createPopulation({}, randomGen) };
+    GeneticPolicies::sortFitterHalf(population);
+    Selection selection;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(selection(population, randomGen));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK_TEMPLATE(BM_selection, GeneticPolicies::TruncationSelection)->Apply(allInstances);
+BENCHMARK_TEMPLATE(BM_selection, GeneticPolicies::TournamentSelection<3>)->Apply(allInstances);
+
+// Bytes per city index: unsigned against the compact 16-bit encoding
+template<typename City>
+void BM_nextGeneration(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED + state.thread_index() };
+    DefaultGeneticEngineOf<City> engine(GeneticPolicies::MatrixDistance { tsp.getDistances() },
+            tsp.getNumOfCities(), { POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS });
+    auto population = engine.createPopulation({}, randomGen);
+    for (auto _ : state)
+    {
+        engine.step(population, randomGen);
+        benchmark::ClobberMemory();
+    }
+    const unsigned numOfOffspring = POPULATION_SIZE - POPULATION_SIZE / 2;
+    state.SetItemsProcessed(state.iterations() * numOfOffspring);
+    state.SetBytesProcessed(state.iterations() * numOfOffspring * tsp.getNumOfCities()
+            * sizeof(City));
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK_TEMPLATE(BM_nextGeneration, unsigned)->Apply(allInstances)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_nextGeneration, std::uint16_t)->Apply(allInstances)
+        ->Unit(benchmark::kMicrosecond);
+
+// Whole runs keeping or rejecting clones: best cost and the share of distinct tours left
+template<typename Duplicates>
+void BM_duplicates(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED };
+    GeneticEngine<GeneticPolicies::TruncationSelection, GeneticPolicies::OrderCrossover,
+            GeneticPolicies::SwapMutation, GeneticPolicies::ReplaceWorstHalf,
+            GeneticPolicies::MatrixDistance, CompactRoute, Duplicates> engine(
+            GeneticPolicies::MatrixDistance { tsp.getDistances() }, tsp.getNumOfCities(),
+            { POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS });
+    const GeneticPolicies::EdgeHash edgeHash;
+    unsigned cost = 0U;
+    std::size_t numOfDistinct = 0U;
+    for (auto _ : state)
+    {
+        auto population = engine.createPopulation({}, randomGen);
+        for (auto i = 0U; i < NUM_OF_GENERATIONS; ++i)
+        {
+            engine.step(population, randomGen);
+        }
+        cost = engine.fittest(population).cost_;
+        std::unordered_set<std::uint64_t> distinct;
+        for (const auto& individual : population)
+        {
+            distinct.insert(edgeHash(individual.route_));
+        }
+        numOfDistinct = distinct.size();
+    }
+    state.counters["cost"] = cost;
+    state.counters["distinct"] = static_cast<double>(numOfDistinct) / POPULATION_SIZE;
+    state.SetItemsProcessed(state.iterations() * NUM_OF_GENERATIONS);
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK_TEMPLATE(BM_duplicates, GeneticPolicies::KeepDuplicates)->Arg(SWISS42)->Arg(PA561)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_duplicates, GeneticPolicies::RejectDuplicates)->Arg(SWISS42)->Arg(PA561)
+        ->Unit(benchmark::kMillisecond);
+
+// Every prebuilt operator combination on one instance, argument indexes allGeneticConfigs
+void BM_geneticConfig(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(SWISS42);
+    const GeneticConfig config { allGeneticConfigs(
+            { POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS })[state.range(0)] };
+    RandomGenerator randomGen { SEED };
+    unsigned cost = 0U;
+    for (auto _ : state)
+    {
+        cost = solveGenetic(tsp.getDistances(), config, randomGen).cost_;
+    }
+    state.counters["cost"] = cost;
+    state.SetItemsProcessed(state.iterations() * NUM_OF_GENERATIONS);
+    state.SetLabel(config.selection_ + "/" + config.crossover_ + "/" + config.mutation_ + "/"
+            + config.replacement_ + "/" + config.duplicates_);
+}
+BENCHMARK(BM_geneticConfig)->Apply(percentiles)->DenseRange(0, 31)
+        ->Unit(benchmark::kMillisecond);
+
+void BM_genetic(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED + state.thread_index() };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tsp.genetic(POPULATION_SIZE, MUTATION_PROBABILITY,
+                NUM_OF_GENERATIONS, randomGen));
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_OF_GENERATIONS);
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK(BM_genetic)->Apply(allInstances)->Unit(benchmark::kMillisecond);
+
+// Thread-scaling curve: items are generations, summed over all islands
+void BM_genetic_multi(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    const unsigned numOfThreads = state.range(1);
+    RandomGenerator randomGen { SEED };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tsp.genetic_multi(POPULATION_SIZE, MUTATION_PROBABILITY,
+                NUM_OF_GENERATIONS, numOfThreads, randomGen));
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_OF_GENERATIONS * (numOfThreads + 1));
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK(BM_genetic_multi)->Apply(instancesAndThreads);
+
+// Same thread-scaling curve without generation barriers: items are offspring
+void BM_genetic_steady(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    const unsigned numOfThreads = state.range(1);
+    RandomGenerator randomGen { SEED };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tsp.genetic_steady(POPULATION_SIZE, MUTATION_PROBABILITY,
+                NUM_OF_GENERATIONS, numOfThreads, randomGen));
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_OF_GENERATIONS
+            * (POPULATION_SIZE - POPULATION_SIZE / 2));
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK(BM_genetic_steady)->Apply(instancesAndThreads);
+
+// Same budget of offspring as BM_genetic, cost is the mean over iterations
+void BM_genetic_adaptive(benchmark::State& state)
+{
+    const TSP& tsp = getInstance(state.range(0));
+    RandomGenerator randomGen { SEED };
+    unsigned long long cost = 0U;
+    for (auto _ : state)
+    {
+        cost += tsp.genetic_adaptive(POPULATION_SIZE, NUM_OF_GENERATIONS, randomGen).cost_;
+    }
+    state.counters["cost"] = static_cast<double>(cost) / state.iterations();
+    state.SetItemsProcessed(state.iterations() * NUM_OF_GENERATIONS
+            * (POPULATION_SIZE - POPULATION_SIZE / 2));
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK(BM_genetic_adaptive)->Apply(allInstances)->Unit(benchmark::kMillisecond);
+
+// Cost of a batch of weight changes on a warm population, should not grow with the instance
+void BM_dynamicChangeWeights(benchmark::State& state)
+{
+    TSP tsp(state.range(0), MIN_COST, MAX_COST);
+    DynamicTSP dynamic(tsp, { POPULATION_SIZE, MUTATION_PROBABILITY, 0 }, SEED);
+    dynamic.reoptimize(1);
+    RandomGenerator randomGen { SEED };
+    std::uniform_int_distribution<unsigned> city(0, tsp.getNumOfCities() - 1);
+    std::uniform_int_distribution<unsigned> weight(MIN_COST, MAX_COST);
+    std::vector<WeightChange> changes(state.range(1));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (auto& change : changes)
+        {
+            change.from_ = city(randomGen);
+            do
+            {
+                change.to_ = city(randomGen);
+            }
+            while (change.to_ == change.from_);
+            change.weight_ = weight(randomGen);
+        }
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(dynamic.changeWeights(changes));
+    }
+    state.SetItemsProcessed(state.iterations() * changes.size());
+}
+BENCHMARK(BM_dynamicChangeWeights)->ArgNames({"cities", "changes"})
+        ->ArgsProduct({{50, 500, 2000}, {1, 16}})
+        ->Unit(benchmark::kMicrosecond);
+
+// Island search with a snapshot every period generations against none, period 0
+void BM_checkpoint(benchmark::State& state)
+{
+    const TSP tsp(state.range(0), MIN_COST, MAX_COST);
+    const Checkpoint::Settings settings { state.range(1) ? "/tmp/bm_checkpoint.bin" : "",
+            static_cast<unsigned>(state.range(1)) };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Checkpoint::Search(tsp, settings).run(
+                { POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS }, 2, SEED));
+    }
+    std::remove(settings.path_.c_str());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_checkpoint)->ArgNames({"cities", "period"})
+        ->ArgsProduct({{100, 1000}, {0, 10}})->Unit(benchmark::kMillisecond);
+
+// Generation of a whole matrix, items are weights
+void BM_generateInstance(benchmark::State& state)
+{
+    InstanceGenerator::Settings settings;
+    settings.kind_ = static_cast<InstanceGenerator::Kind>(state.range(0));
+    settings.numOfCities_ = state.range(1);
+    settings.numOfThreads_ = state.range(2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(InstanceGenerator::generate(settings));
+    }
+    state.SetItemsProcessed(state.iterations() * settings.numOfCities_
+            * settings.numOfCities_);
+}
+BENCHMARK(BM_generateInstance)->ArgNames({"kind", "cities", "threads"})
+        ->ArgsProduct({{0, 1, 2}, {1000, 10000}, {1, 4}})->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+
+// Fixed size path against the generic engine on the same micro instances
+void BM_smallGenetic(benchmark::State& state)
+{
+    const TSP tsp(state.range(0), MIN_COST, MAX_COST);
+    RandomGenerator randomGen { SEED };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(SmallInstances::genetic(tsp.getDistances(),
+                { POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS }, randomGen));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_smallGenetic)->Apply(percentiles)->Arg(8)->Arg(16)->Arg(32)
+        ->Unit(benchmark::kMicrosecond);
+
+void BM_genericGenetic(benchmark::State& state)
+{
+    const TSP tsp(state.range(0), MIN_COST, MAX_COST);
+    RandomGenerator randomGen { SEED };
+    for (auto _ : state)
+    {
+        DefaultGeneticEngine engine(GeneticPolicies::MatrixDistance { tsp.getDistances() },
+                tsp.getNumOfCities(), { POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS });
+        benchmark::DoNotOptimize(engine.run(randomGen));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_genericGenetic)->Apply(percentiles)->Arg(8)->Arg(16)->Arg(32)
+        ->Unit(benchmark::kMicrosecond);
+
+void BM_bruteForce(benchmark::State& state)
+{
+    const TSP tsp(state.range(0), MIN_COST, MAX_COST);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tsp.bruteForce());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_bruteForce)->Apply(percentiles)->DenseRange(6, 10)->Unit(benchmark::kMillisecond);
+
+void BM_parseFile(benchmark::State& state)
+{
+    const std::string path { dataDir() + instanceName(state.range(0)) + ".tsp" };
+    unsigned numOfCities = 0;
+    for (auto _ : state)
+    {
+        const TSP tsp(path);
+        numOfCities = tsp.getNumOfCities();
+    }
+    state.SetItemsProcessed(state.iterations() * numOfCities * (numOfCities - 1) / 2);
+    state.SetLabel(instanceName(state.range(0)));
+}
+BENCHMARK(BM_parseFile)->Apply(percentiles)->Arg(SWISS42)->Arg(PA561)
+        ->Unit(benchmark::kMillisecond);
+
+}
@@ -0,0 +1,486 @@
+#include "Checkpoint.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace Checkpoint
+{
+
+namespace
+{
+
+const char MAGIC[] = { 'Z', 'W', 'C', 'P' };
+constexpr std::uint32_t VERSION = 2;
+
+template<typename T>
+void put(std::ostream& os, const T value, const unsigned numOfBytes = sizeof(T))
+{
+    for (auto i = 0U; i < numOfBytes; ++i)
+    {
+        os.put(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+void putString(std::ostream& os, const std::string& text)
+{
+    put<std::uint32_t>(os, text.size());
+    os.write(text.data(), text.size());
+}
+
+template<typename T>
+T get(std::istream& is, const unsigned numOfBytes = sizeof(T))
+{
+    std::uint64_t value = 0U;
+    for (auto i = 0U; i < numOfBytes; ++i)
+    {
+        const auto byte = is.get();
+        if (byte == std::char_traits<char>::eof())
+        {
+            throw std::runtime_error { " * Truncated snapshot * " };
+        }
+        value |= static_cast<std::uint64_t>(byte) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+std::string getString(std::istream& is)
+{
+    const auto size = get<std::uint32_t>(is);
+    std::string text(size, '\0');
+    if (!is.read(&text[0], size))
+    {
+        throw std::runtime_error { " * Truncated snapshot * " };
+    }
+    return text;
+}
+
+// Bytes between the position of a seekable stream and its end, the maximum otherwise
+std::uint64_t bytesLeft(std::istream& is)
+{
+    const auto position = is.tellg();
+    if (position < 0 || !is.seekg(0, std::ios::end))
+    {
+        is.clear();
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    const auto end = is.tellg();
+    is.seekg(position);
+    return end > position ? static_cast<std::uint64_t>(end - position) : 0U;
+}
+
+// FNV-1a of every weight
+std::uint64_t hashOf(const DistanceMatrix& distances)
+{
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (auto from = 0U; from < distances.getNumOfCities(); ++from)
+    {
+        for (auto to = 0U; to < distances.getNumOfCities(); ++to)
+        {
+            hash = (hash ^ distances(from, to)) * 0x100000001B3ULL;
+        }
+    }
+    return hash;
+}
+
+// Reads all of text into value, throws std::runtime_error if it isn't exactly one value
+template<typename T>
+void parse(const std::string& text, T& value)
+{
+    std::istringstream ss(text);
+    if (!(ss >> value) || !(ss >> std::ws).eof())
+    {
+        throw std::runtime_error { " * Corrupted snapshot * " };
+    }
+}
+
+std::string toString(const long double value)
+{
+    std::ostringstream ss;
+    ss.precision(std::numeric_limits<long double>::max_digits10);
+    ss << value;
+    return ss.str();
+}
+
+template<typename City>
+using Engine = DefaultGeneticEngineOf<City>;
+
+// Copy of a running island, taken by the island itself between generations
+template<typename City>
+IslandState capture(const typename Engine<City>::Individuals& population,
+        const RandomGenerator& randomGen, const unsigned generation)
+{
+    IslandState state;
+    state.generation_ = generation;
+    std::ostringstream ss;
+    ss << randomGen;
+    state.randomGen_ = ss.str();
+    for (const auto& individual : population)
+    {
+        state.routes_.emplace_back(individual.route_.begin(), individual.route_.end());
+    }
+    return state;
+}
+
+// Gathers the islands' states of one generation into a snapshot
+class Collector
+{
+public:
+    Collector(const Snapshot& header, Writer* writer)
+            : header_ { header }, writer_ { writer }
+    {}
+
+    void deposit(const unsigned island, IslandState state)
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        auto& entry = pending_[state.generation_];
+        if (entry.second.islands_.empty())
+        {
+            entry.second = header_;
+            entry.second.islands_.resize(header_.islands_.size());
+        }
+        const unsigned generation = state.generation_;
+        entry.second.islands_[island] = std::move(state);
+        if (++entry.first == header_.islands_.size())
+        {
+            writer_->submit(std::move(entry.second));
+            pending_.erase(generation);
+        }
+    }
+
+private:
+    const Snapshot& header_;
+    Writer* const writer_;
+    std::mutex m_;
+    // Generation -> number of islands deposited and their states
+    std::map<unsigned, std::pair<unsigned, Snapshot>> pending_;
+};
+
+template<typename City>
+Route evolveIsland(const TSP& tsp, const GeneticParameters& parameters, IslandState state,
+        const unsigned island, const unsigned period, Collector* collector)
+{
+    Engine<City> engine(GeneticPolicies::MatrixDistance { tsp.getDistances() },
+            tsp.getNumOfCities(), parameters);
+    RandomGenerator randomGen;
+    std::istringstream(state.randomGen_) >> randomGen;
+
+    // Restored routes keep their order and draw nothing from the generator
+    typename Engine<City>::Routes routes;
+    for (const auto& route : state.routes_)
+    {
+        routes.emplace_back(route.begin(), route.end());
+    }
+    state.routes_.clear();
+    auto population = engine.createPopulation(std::move(routes), randomGen);
+
+    for (auto generation = state.generation_; generation < parameters.numOfGenerations_;)
+    {
+        engine.step(population, randomGen);
+        ++generation;
+        if (collector && period && generation % period == 0
+                && generation < parameters.numOfGenerations_)
+        {
+            collector->deposit(island, capture<City>(population, randomGen, generation));
+        }
+    }
+    const auto best = Engine<City>::fittest(population);
+    return Route(best.route_.begin(), best.route_.end());
+}
+
+// Island seeds first, then the one breeding the islands' results together
+std::vector<std::uint64_t> seedsOf(const std::uint64_t seed, const unsigned numOfIslands)
+{
+    RandomGenerator randomGen { seed };
+    std::vector<std::uint64_t> seeds;
+    for (auto i = 0U; i <= numOfIslands; ++i)
+    {
+        seeds.push_back(randomGen());
+    }
+    return seeds;
+}
+
+}
+
+void write(std::ostream& os, const Snapshot& snapshot)
+{
+    const unsigned bytesPerCity = fitsCityType<std::uint16_t>(snapshot.numOfCities_) ? 2 : 4;
+    os.write(MAGIC, sizeof(MAGIC));
+    put<std::uint32_t>(os, VERSION);
+    put<std::uint32_t>(os, snapshot.numOfCities_);
+    put<std::uint32_t>(os, snapshot.parameters_.populationSize_);
+    putString(os, toString(snapshot.parameters_.mutationProbability_));
+    put<std::uint32_t>(os, snapshot.parameters_.numOfGenerations_);
+    put<std::uint64_t>(os, snapshot.seed_);
+    put<std::uint64_t>(os, snapshot.weightsHash_);
+    put<std::uint8_t>(os, bytesPerCity);
+    put<std::uint32_t>(os, snapshot.islands_.size());
+    for (const auto& island : snapshot.islands_)
+    {
+        put<std::uint32_t>(os, island.generation_);
+        putString(os, island.randomGen_);
+        put<std::uint32_t>(os, island.routes_.size());
+        for (const auto& route : island.routes_)
+        {
+            for (const auto city : route)
+            {
+                put(os, city, bytesPerCity);
+            }
+        }
+    }
+    if (!os)
+    {
+        throw std::runtime_error { " * Couldn't write snapshot * " };
+    }
+}
+
+Snapshot read(std::istream& is)
+{
+    char magic[sizeof(MAGIC)];
+    if (!is.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)
+            || get<std::uint32_t>(is) != VERSION)
+    {
+        throw std::runtime_error { " * Not a snapshot * " };
+    }
+
+    Snapshot snapshot;
+    snapshot.numOfCities_ = get<std::uint32_t>(is);
+    snapshot.parameters_.populationSize_ = get<std::uint32_t>(is);
+    parse(getString(is), snapshot.parameters_.mutationProbability_);
+    snapshot.parameters_.numOfGenerations_ = get<std::uint32_t>(is);
+    snapshot.seed_ = get<std::uint64_t>(is);
+    snapshot.weightsHash_ = get<std::uint64_t>(is);
+    const unsigned bytesPerCity = get<std::uint8_t>(is);
+    if (bytesPerCity != 2 && bytesPerCity != 4)
+    {
+        throw std::runtime_error { " * Not a snapshot * " };
+    }
+
+    // Counts are checked against what is left, so a corrupted one can't allocate much
+    const unsigned n = snapshot.numOfCities_;
+    const std::uint64_t routeSize { static_cast<std::uint64_t>(n) * bytesPerCity };
+    const auto numOfIslands = get<std::uint32_t>(is);
+    // Generation, generator state's length and numOfIndividuals
+    if (numOfIslands > bytesLeft(is) / 12)
+    {
+        throw std::runtime_error { " * Truncated snapshot * " };
+    }
+    std::vector<bool> visited;
+    for (auto i = 0U; i < numOfIslands; ++i)
+    {
+        IslandState island;
+        island.generation_ = get<std::uint32_t>(is);
+        island.randomGen_ = getString(is);
+        RandomGenerator randomGen;
+        parse(island.randomGen_, randomGen);
+        const auto numOfRoutes = get<std::uint32_t>(is);
+        if (numOfRoutes > 0 && (routeSize == 0 || numOfRoutes > bytesLeft(is) / routeSize))
+        {
+            throw std::runtime_error { " * Truncated snapshot * " };
+        }
+        for (auto j = 0U; j < numOfRoutes; ++j)
+        {
+            Route route;
+            visited.assign(n, false);
+            for (auto k = 0U; k < n; ++k)
+            {
+                const auto city = get<unsigned>(is, bytesPerCity);
+                if (city >= n || visited[city])
+                {
+                    throw std::runtime_error { " * Snapshot route isn't a permutation * " };
+                }
+                visited[city] = true;
+                route.push_back(city);
+            }
+            island.routes_.push_back(std::move(route));
+        }
+        snapshot.islands_.push_back(std::move(island));
+    }
+    return snapshot;
+}
+
+void writeFile(const std::string& path, const Snapshot& snapshot)
+{
+    const std::string temporary { path + ".tmp" };
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            throw std::runtime_error { " * Couldn't open " + temporary + " * " };
+        }
+        write(file, snapshot);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        throw std::runtime_error { " * Couldn't replace " + path + " * " };
+    }
+}
+
+Snapshot readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error { " * Couldn't open " + path + " * " };
+    }
+    return read(file);
+}
+
+Writer::Writer(const std::string& path)
+        : path_ { path }, thread_ { [this](){work();} }
+{}
+
+Writer::~Writer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void Writer::submit(Snapshot snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        pending_.reset(new Snapshot(std::move(snapshot)));
+    }
+    cv_.notify_one();
+}
+
+unsigned Writer::getNumOfWritten() const
+{
+    return numOfWritten_.load();
+}
+
+std::string Writer::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return lastError_;
+}
+
+void Writer::work()
+{
+    while (true)
+    {
+        std::unique_ptr<Snapshot> snapshot;
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            cv_.wait(lock, [this](){return stopping_ || pending_;});
+            if (!pending_)
+            {
+                return;
+            }
+            snapshot = std::move(pending_);
+        }
+        try
+        {
+            writeFile(path_, *snapshot);
+            ++numOfWritten_;
+        }
+        catch (const std::exception& e)
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            lastError_ = e.what();
+        }
+    }
+}
+
+Search::Search(const TSP& tsp, const Settings& settings)
+        : tsp_ { tsp }, settings_ { settings }
+{}
+
+Solution Search::run(const GeneticParameters& parameters, const unsigned numOfIslands,
+        const std::uint64_t seed)
+{
+    Snapshot snapshot;
+    snapshot.numOfCities_ = tsp_.getNumOfCities();
+    snapshot.parameters_ = parameters;
+    snapshot.seed_ = seed;
+    snapshot.weightsHash_ = hashOf(tsp_.getDistances());
+    const auto seeds = seedsOf(seed, std::max(numOfIslands, 1U));
+    for (auto i = 0U; i + 1 < seeds.size(); ++i)
+    {
+        IslandState island;
+        std::ostringstream ss;
+        ss << RandomGenerator { seeds[i] };
+        island.randomGen_ = ss.str();
+        snapshot.islands_.push_back(std::move(island));
+    }
+    return evolve(std::move(snapshot));
+}
+
+Solution Search::resume(const Snapshot& snapshot)
+{
+    if (snapshot.numOfCities_ != tsp_.getNumOfCities() || snapshot.islands_.empty()
+            || snapshot.weightsHash_ != hashOf(tsp_.getDistances()))
+    {
+        throw std::runtime_error { " * Snapshot of " + std::to_string(snapshot.numOfCities_)
+                + " cities doesn't match the instance * " };
+    }
+    // Selection and replacement count on a whole population
+    for (const auto& island : snapshot.islands_)
+    {
+        if ((!island.routes_.empty()
+                && island.routes_.size() != snapshot.parameters_.populationSize_)
+                || island.generation_ > snapshot.parameters_.numOfGenerations_)
+        {
+            throw std::runtime_error { " * Snapshot island isn't a population of the search * " };
+        }
+    }
+    return evolve(snapshot);
+}
+
+Solution Search::evolve(Snapshot snapshot)
+{
+    const GeneticParameters parameters { snapshot.parameters_ };
+    const unsigned numOfIslands = snapshot.islands_.size();
+    // Header of the snapshots taken from now on, their islands are filled by the collector
+    Snapshot header { snapshot };
+    for (auto& island : header.islands_)
+    {
+        island = IslandState();
+    }
+    std::unique_ptr<Writer> writer;
+    std::unique_ptr<Collector> collector;
+    if (!settings_.path_.empty())
+    {
+        writer.reset(new Writer(settings_.path_));
+        collector.reset(new Collector(header, writer.get()));
+    }
+
+    const bool compact = fitsCityType<std::uint16_t>(tsp_.getNumOfCities());
+    std::vector<std::future<Route>> futures;
+    for (auto i = 0U; i < numOfIslands; ++i)
+    {
+        IslandState state { std::move(snapshot.islands_[i]) };
+        futures.emplace_back(std::async(std::launch::async,
+                [this, &parameters, &collector, compact, i](IslandState state)
+                {
+                    return compact ?
+                            evolveIsland<std::uint16_t>(tsp_, parameters, std::move(state), i,
+                                    settings_.period_, collector.get()) :
+                            evolveIsland<unsigned>(tsp_, parameters, std::move(state), i,
+                                    settings_.period_, collector.get());
+                }, std::move(state)));
+    }
+
+    // Indexed by island, so the result doesn't depend on which island finished first
+    Population population;
+    for (auto& f : futures)
+    {
+        population.push_back(f.get());
+    }
+    RandomGenerator mergeGen { seedsOf(snapshot.seed_, numOfIslands).back() };
+    return tsp_.genetic(population.size(), parameters.mutationProbability_,
+            parameters.numOfGenerations_, mergeGen, population);
+}
+
+}
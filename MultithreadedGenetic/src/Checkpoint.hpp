@@ -0,0 +1,122 @@
+#ifndef CHECKPOINT_HPP_
+#define CHECKPOINT_HPP_
+
+#include "GeneticEngine.hpp"
+#include "TSP.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Snapshots of an island search that can be resumed later, possibly on another machine.
+ * A snapshot holds everything the islands' trajectories depend on: populations in their
+ * current order, generator states and generation counters, so a resumed search ends
+ * exactly like the one that wasn't interrupted. Costs aren't stored, routes are evaluated
+ * again on the instance they are resumed on.
+ *
+ * Binary format, little-endian:
+ *   "ZWCP" u32 version, u32 numOfCities, u32 populationSize, str mutationProbability,
+ *   u32 numOfGenerations, u64 seed, u64 weights hash, u8 bytes per city, u32 numOfIslands,
+ *   then per island u32 generation, str generator state, u32 numOfIndividuals, cities[]
+ * where str is u32 length and bytes. Cities take 2 bytes when the instance allows it.
+ */
+namespace Checkpoint
+{
+
+struct IslandState
+{
+    unsigned generation_ = 0U;
+    // Textual state of RandomGenerator, the only portable one the standard offers
+    std::string randomGen_;
+    Population routes_;
+};
+
+struct Snapshot
+{
+    unsigned numOfCities_ = 0U;
+    GeneticParameters parameters_;
+    std::uint64_t seed_ = 0U;
+    // Of the instance's weights, a snapshot resumes only on the instance it was taken of
+    std::uint64_t weightsHash_ = 0U;
+    std::vector<IslandState> islands_;
+};
+
+// Both throw std::runtime_error, read() on anything that isn't a complete snapshot
+// of permutations
+void write(std::ostream& os, const Snapshot& snapshot);
+Snapshot read(std::istream& is);
+// Writes to a temporary file renamed over path, so path always holds a whole snapshot
+void writeFile(const std::string& path, const Snapshot& snapshot);
+Snapshot readFile(const std::string& path);
+
+/*
+ * Background thread writing submitted snapshots to one file. submit() only hands the
+ * snapshot over, when the thread is still busy with the previous one, the newest waiting
+ * snapshot replaces the older. The destructor writes the last submitted snapshot.
+ */
+class Writer
+{
+public:
+    explicit Writer(const std::string& path);
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    ~Writer();
+
+    void submit(Snapshot snapshot);
+    unsigned getNumOfWritten() const;
+    // Message of the last failed write, empty if none failed
+    std::string getLastError() const;
+
+private:
+    void work();
+
+    const std::string path_;
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::unique_ptr<Snapshot> pending_;
+    bool stopping_ = false;
+    std::atomic<unsigned> numOfWritten_ { 0U };
+    std::string lastError_;
+    std::thread thread_;
+};
+
+struct Settings
+{
+    std::string path_;    // no snapshots when empty
+    unsigned period_ = 50;  // generations between snapshots
+};
+
+/*
+ * Islands evolving independently, like TSP::genetic_multi, then bred together.
+ * Every period_ generations each island copies its state and goes on; the island that
+ * completes the set for a generation hands the snapshot to the writer. No island waits
+ * for another one or for the disk.
+ */
+class Search
+{
+public:
+    Search(const TSP& tsp, const Settings& settings);
+
+    Solution run(const GeneticParameters& parameters, const unsigned numOfIslands,
+            const std::uint64_t seed);
+    // Throws std::runtime_error if the snapshot is of another instance, or an island's
+    // population or generation doesn't fit the snapshot's parameters
+    Solution resume(const Snapshot& snapshot);
+
+private:
+    Solution evolve(Snapshot snapshot);
+
+    const TSP& tsp_;
+    const Settings settings_;
+};
+
+}
+
+#endif /* CHECKPOINT_HPP_ */
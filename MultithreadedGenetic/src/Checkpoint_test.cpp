@@ -0,0 +1,114 @@
+#include "Checkpoint.hpp"
+#include "TemporaryFile.hpp"
+#include "TSP.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+class CheckpointFixture : public ::testing::Test
+{
+protected:
+    TSP tsp_{"/home/dec/studia/sem6/zwsisk/swiss42.tsp"};
+    const TemporaryFile file_ { "checkpoint_test" };
+    const std::string& path_ { file_.getPath() };
+};
+
+TEST(Checkpoint, roundTripsSnapshot)
+{
+    Checkpoint::Snapshot snapshot;
+    snapshot.numOfCities_ = 3;
+    snapshot.parameters_ = { 2, 0.1, 40 };
+    snapshot.seed_ = 0x0123456789ABCDEFULL;
+    snapshot.weightsHash_ = 77;
+    Checkpoint::IslandState island;
+    island.generation_ = 20;
+    std::ostringstream state;
+    state << RandomGenerator { 3 };
+    island.randomGen_ = state.str();
+    island.routes_ = { { 0, 1, 2 }, { 2, 0, 1 } };
+    snapshot.islands_ = { island, island };
+
+    std::stringstream ss;
+    Checkpoint::write(ss, snapshot);
+    const Checkpoint::Snapshot copy { Checkpoint::read(ss) };
+    ASSERT_EQ(3U, copy.numOfCities_);
+    ASSERT_EQ(40U, copy.parameters_.numOfGenerations_);
+    ASSERT_EQ(snapshot.parameters_.mutationProbability_, copy.parameters_.mutationProbability_);
+    ASSERT_EQ(snapshot.seed_, copy.seed_);
+    ASSERT_EQ(77U, copy.weightsHash_);
+    ASSERT_EQ(2U, copy.islands_.size());
+    ASSERT_EQ(20U, copy.islands_[1].generation_);
+    ASSERT_EQ(state.str(), copy.islands_[1].randomGen_);
+    ASSERT_EQ(island.routes_, copy.islands_[1].routes_);
+
+    const std::string bytes { ss.str() };
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+    ASSERT_THROW(Checkpoint::read(truncated), std::runtime_error);
+    std::istringstream garbage("ZWXX" + bytes.substr(4));
+    ASSERT_THROW(Checkpoint::read(garbage), std::runtime_error);
+
+    snapshot.islands_[0].routes_[1] = { 2, 0, 2 };
+    std::stringstream repeated;
+    Checkpoint::write(repeated, snapshot);
+    ASSERT_THROW(Checkpoint::read(repeated), std::runtime_error);
+    snapshot.islands_[0].routes_[1] = { 2, 0, 1 };
+
+    snapshot.islands_[1].randomGen_ = "1 2 3";
+    std::stringstream badGenerator;
+    Checkpoint::write(badGenerator, snapshot);
+    ASSERT_THROW(Checkpoint::read(badGenerator), std::runtime_error);
+
+    // Number of islands right before the first island's generation
+    std::string corrupted { bytes };
+    const auto numOfIslands = bytes.size() - 2 * (4 + 4 + state.str().size() + 4 + 2 * 3 * 2)
+            - 4;
+    ASSERT_EQ(std::string("\x02\0\0\0", 4), bytes.substr(numOfIslands, 4));
+    corrupted.replace(numOfIslands, 4, "\xFF\xFF\xFF\x7F");
+    std::istringstream huge(corrupted);
+    ASSERT_THROW(Checkpoint::read(huge), std::runtime_error);
+
+    // Mutation probability "0.1" follows the header's three u32s
+    std::string probability { bytes };
+    const auto at = probability.find("0.1", 4 + 4 * 3 + 4);
+    ASSERT_NE(std::string::npos, at);
+    probability[at] = 'x';
+    std::istringstream unparsable(probability);
+    ASSERT_THROW(Checkpoint::read(unparsable), std::runtime_error);
+}
+
+TEST_F(CheckpointFixture, resumedSearchEndsLikeUninterrupted)
+{
+    const GeneticParameters parameters { 30, 0.2, 35 };
+    const Solution uninterrupted { Checkpoint::Search(tsp_, {}).run(parameters, 2, 9) };
+
+    const Solution checkpointed { Checkpoint::Search(tsp_, { path_, 10 }).run(parameters, 2, 9) };
+    ASSERT_EQ(uninterrupted.route_, checkpointed.route_);
+
+    const Checkpoint::Snapshot snapshot { Checkpoint::readFile(path_) };
+    ASSERT_EQ(2U, snapshot.islands_.size());
+    for (const auto& island : snapshot.islands_)
+    {
+        ASSERT_EQ(30U, island.generation_);
+        ASSERT_EQ(parameters.populationSize_, island.routes_.size());
+    }
+    const Solution resumed { Checkpoint::Search(tsp_, {}).resume(snapshot) };
+    ASSERT_EQ(uninterrupted.cost_, resumed.cost_);
+    ASSERT_EQ(uninterrupted.route_, resumed.route_);
+
+    TSP other{"/home/dec/studia/sem6/zwsisk/graph_full_matrix.txt"};
+    ASSERT_THROW(Checkpoint::Search(other, {}).resume(snapshot), std::runtime_error);
+    Checkpoint::Snapshot reweighted { snapshot };
+    ++reweighted.weightsHash_;
+    ASSERT_THROW(Checkpoint::Search(tsp_, {}).resume(reweighted), std::runtime_error);
+
+    Checkpoint::Snapshot shrunk { snapshot };
+    shrunk.islands_[0].routes_.resize(3);
+    ASSERT_THROW(Checkpoint::Search(tsp_, {}).resume(shrunk), std::runtime_error);
+    Checkpoint::Snapshot overrun { snapshot };
+    overrun.islands_[1].generation_ = parameters.numOfGenerations_ + 1;
+    ASSERT_THROW(Checkpoint::Search(tsp_, {}).resume(overrun), std::runtime_error);
+}
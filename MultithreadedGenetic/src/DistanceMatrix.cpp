@@ -0,0 +1,35 @@
+#include "DistanceMatrix.hpp"
+
+#include <utility>
+
+DistanceMatrix::DistanceMatrix(const UndirectedGraph& graph)
+        : numOfCities_ { graph.getNumberOfVertices() },
+          weights_(static_cast<std::size_t>(numOfCities_) * numOfCities_, 0U)
+{
+    for (auto from = 0U; from < numOfCities_; ++from)
+    {
+        unsigned* row = &weights_[static_cast<std::size_t>(from) * numOfCities_];
+        for (auto to = 0U; to < numOfCities_; ++to)
+        {
+            if (graph.edgeExists(from, to))
+            {
+                row[to] = graph.getWeightOfEdge(from, to);
+            }
+        }
+    }
+}
+
+DistanceMatrix::DistanceMatrix(const unsigned numOfCities, std::vector<unsigned> weights)
+        : numOfCities_ { numOfCities }, weights_ { std::move(weights) }
+{}
+
+void DistanceMatrix::setWeight(const unsigned from, const unsigned to, const unsigned weight)
+{
+    weights_[static_cast<std::size_t>(from) * numOfCities_ + to] = weight;
+    weights_[static_cast<std::size_t>(to) * numOfCities_ + from] = weight;
+}
+
+unsigned DistanceMatrix::getNumOfCities() const
+{
+    return numOfCities_;
+}
@@ -0,0 +1,38 @@
+#ifndef DISTANCEMATRIX_HPP_
+#define DISTANCEMATRIX_HPP_
+
+#include "UndirectedGraph.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * Flat, row-major copy of the edge weights used on the solvers' hot path.
+ * Lookups are unchecked, validation is done by UndirectedGraph.
+ * A copy is first touched by the copying thread, so copying on a thread pinned
+ * to a NUMA node places the replica in that node's memory.
+ */
+class DistanceMatrix
+{
+public:
+    DistanceMatrix() = default;
+    explicit DistanceMatrix(const UndirectedGraph& graph);
+    // Takes numOfCities * numOfCities row-major weights, e.g. of a generated instance
+    DistanceMatrix(const unsigned numOfCities, std::vector<unsigned> weights);
+
+    unsigned operator()(const unsigned from, const unsigned to) const
+    {
+        return weights_[static_cast<std::size_t>(from) * numOfCities_ + to];
+    }
+
+    // Sets both directions, unchecked like lookups
+    void setWeight(const unsigned from, const unsigned to, const unsigned weight);
+
+    unsigned getNumOfCities() const;
+
+private:
+    unsigned numOfCities_ = 0U;
+    std::vector<unsigned> weights_;
+};
+
+#endif /* DISTANCEMATRIX_HPP_ */
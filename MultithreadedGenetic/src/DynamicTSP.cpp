@@ -0,0 +1,99 @@
+#include "DynamicTSP.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+DynamicTSP::DynamicTSP(TSP& tsp, const GeneticParameters& parameters, const std::uint64_t seed)
+        : tsp_ { tsp }, numOfCities_ { tsp.getNumOfCities() }, randomGen_ { seed },
+          engine_ { GeneticPolicies::MatrixDistance { tsp.getDistances() }, numOfCities_,
+                  parameters }
+{}
+
+Solution DynamicTSP::reoptimize(const unsigned numOfGenerations)
+{
+    if (population_.empty())
+    {
+        population_ = engine_.createPopulation({}, randomGen_);
+    }
+    for (auto i = 0U; i < numOfGenerations; ++i)
+    {
+        engine_.step(population_, randomGen_);
+    }
+    indexPositions();
+    return getBest();
+}
+
+unsigned DynamicTSP::changeWeights(const std::vector<WeightChange>& changes)
+{
+    // Weights before each change, a batch may change the same edge more than once
+    std::vector<unsigned> oldWeights;
+    for (auto i = 0U; i < changes.size(); ++i)
+    {
+        unsigned oldWeight = tsp_.getCostBetweenCities(changes[i].from_, changes[i].to_);
+        for (auto j = 0U; j < i; ++j)
+        {
+            if ((changes[j].from_ == changes[i].from_ && changes[j].to_ == changes[i].to_)
+                    || (changes[j].from_ == changes[i].to_ && changes[j].to_ == changes[i].from_))
+            {
+                oldWeight = changes[j].weight_;
+            }
+        }
+        oldWeights.push_back(oldWeight);
+    }
+    tsp_.changeWeights(changes);
+
+    std::vector<char> changed(population_.size(), false);
+    for (auto i = 0U; i < changes.size(); ++i)
+    {
+        for (auto individual = 0U; individual < population_.size(); ++individual)
+        {
+            const unsigned uses = countUses(individual, changes[i].from_, changes[i].to_);
+            if (uses > 0U)
+            {
+                // Unsigned wrap-around cancels out, the final cost is never negative
+                population_[individual].cost_ += uses * (changes[i].weight_ - oldWeights[i]);
+                changed[individual] = true;
+            }
+        }
+    }
+    return std::count(changed.begin(), changed.end(), true);
+}
+
+Solution DynamicTSP::getBest() const
+{
+    if (population_.empty())
+    {
+        return {};
+    }
+    const auto best = Engine::fittest(population_);
+    return {best.cost_, best.route_};
+}
+
+const DynamicTSP::Individuals& DynamicTSP::getPopulation() const
+{
+    return population_;
+}
+
+void DynamicTSP::indexPositions()
+{
+    positions_.resize(population_.size() * static_cast<std::size_t>(numOfCities_));
+    for (auto i = 0U; i < population_.size(); ++i)
+    {
+        unsigned* positions = &positions_[i * static_cast<std::size_t>(numOfCities_)];
+        const Route& route = population_[i].route_;
+        for (auto j = 0U; j < numOfCities_; ++j)
+        {
+            positions[route[j]] = j;
+        }
+    }
+}
+
+unsigned DynamicTSP::countUses(const unsigned individual, const unsigned from,
+        const unsigned to) const
+{
+    const Route& route = population_[individual].route_;
+    const unsigned position = positions_[individual * static_cast<std::size_t>(numOfCities_)
+            + from];
+    return (route[(position + 1) % numOfCities_] == to)
+            + (route[(position + numOfCities_ - 1) % numOfCities_] == to);
+}
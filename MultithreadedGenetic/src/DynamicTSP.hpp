@@ -0,0 +1,49 @@
+#ifndef DYNAMICTSP_HPP_
+#define DYNAMICTSP_HPP_
+
+#include "GeneticEngine.hpp"
+#include "TSP.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * Re-optimisation of an instance whose edge weights change over time.
+ * The population survives between solves, so every solve is warm-started from the routes
+ * found so far. When weights change, only the cached costs of the routes using a changed
+ * edge are corrected, each in O(1) thanks to the index of city positions in every route.
+ * Not thread-safe, and the instance must not be solved by anyone else meanwhile.
+ */
+class DynamicTSP
+{
+public:
+    using Engine = DefaultGeneticEngine;
+    using Individuals = Engine::Individuals;
+
+    DynamicTSP(TSP& tsp, const GeneticParameters& parameters, const std::uint64_t seed);
+
+    // Evolves the kept population, the first call starts from random routes
+    Solution reoptimize(const unsigned numOfGenerations);
+
+    // Changes the weights of the instance, see TSP::changeWeights.
+    // Returns the number of kept routes whose cost changed.
+    unsigned changeWeights(const std::vector<WeightChange>& changes);
+
+    Solution getBest() const;
+    const Individuals& getPopulation() const;
+
+private:
+    void indexPositions();
+    // How many times the route of individual uses the edge, two only for two cities
+    unsigned countUses(const unsigned individual, const unsigned from, const unsigned to) const;
+
+    TSP& tsp_;
+    const unsigned numOfCities_;
+    RandomGenerator randomGen_;
+    Engine engine_;
+    Individuals population_;
+    // positions_[i * numOfCities_ + city] is the index of city in the route of individual i
+    std::vector<unsigned> positions_;
+};
+
+#endif /* DYNAMICTSP_HPP_ */
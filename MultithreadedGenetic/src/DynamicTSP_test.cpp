@@ -0,0 +1,61 @@
+#include "DynamicTSP.hpp"
+#include "TSP.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+class DynamicTSPFixture : public ::testing::Test
+{
+protected:
+    void expectCachedCostsMatch() const
+    {
+        for (const auto& individual : dynamic_.getPopulation())
+        {
+            ASSERT_EQ(tsp_.calcCostOfRoute(individual.route_), individual.cost_);
+        }
+    }
+
+    TSP tsp_{"/home/dec/studia/sem6/zwsisk/swiss42.tsp"};
+    DynamicTSP dynamic_{tsp_, { 30, 0.1, 0 }, 17};
+};
+
+TEST_F(DynamicTSPFixture, changesWeightsOfInstance)
+{
+    tsp_.changeWeights({{3, 7, 1}, {7, 3, 2}});
+    ASSERT_EQ(2, tsp_.getCostBetweenCities(3, 7));
+    ASSERT_EQ(2, tsp_.getDistances()(7, 3));
+    ASSERT_THROW(tsp_.changeWeights({{1, 2, 5}, {4, 4, 5}}), std::runtime_error);
+    ASSERT_THROW(tsp_.changeWeights({{1, 2, 0}}), std::runtime_error);
+    ASSERT_NE(5, tsp_.getCostBetweenCities(1, 2));
+}
+
+TEST_F(DynamicTSPFixture, correctsCachedCostsOfAffectedRoutes)
+{
+    const Solution before { dynamic_.reoptimize(20) };
+    const unsigned from = before.route_[0];
+    const unsigned to = before.route_[1];
+    const unsigned weight = tsp_.getCostBetweenCities(from, to);
+
+    ASSERT_GE(dynamic_.changeWeights({{from, to, weight + 1000}, {5, 9, 1},
+            {to, from, weight + 500}}), 1U);
+    expectCachedCostsMatch();
+    ASSERT_EQ(weight + 500, tsp_.getCostBetweenCities(from, to));
+
+    ASSERT_EQ(0U, dynamic_.changeWeights({}));
+    ASSERT_THROW(dynamic_.changeWeights({{from, to, 0}}), std::runtime_error);
+    expectCachedCostsMatch();
+}
+
+TEST_F(DynamicTSPFixture, warmStartKeepsBestRoute)
+{
+    dynamic_.reoptimize(50);
+    dynamic_.changeWeights({{0, 1, 1}, {2, 3, 4000}});
+    const unsigned best = dynamic_.getBest().cost_;
+    const Solution after { dynamic_.reoptimize(5) };
+    ASSERT_LE(after.cost_, best);
+    ASSERT_EQ(tsp_.calcCostOfRoute(after.route_), after.cost_);
+    expectCachedCostsMatch();
+}
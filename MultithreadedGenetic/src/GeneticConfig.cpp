@@ -0,0 +1,138 @@
+#include "GeneticConfig.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+using namespace GeneticPolicies;
+
+namespace
+{
+
+[[noreturn]] void throwUnknown(const std::string& kind, const std::string& name)
+{
+    throw std::runtime_error { " * Unknown " + kind + " operator: " + name + " * " };
+}
+
+template<typename S, typename C, typename M, typename R, typename D>
+Solution run(const DistanceMatrix& distances, const GeneticConfig& config,
+        RandomGenerator& randomGen, Population routes)
+{
+    const unsigned numOfCities = distances.getNumOfCities();
+    if (fitsCityType<std::uint16_t>(numOfCities))
+    {
+        GeneticEngine<S, C, M, R, MatrixDistance, CompactRoute, D> engine(
+                MatrixDistance { distances }, numOfCities, config.parameters_);
+        return runOnRoutes(engine, randomGen, routes);
+    }
+    GeneticEngine<S, C, M, R, MatrixDistance, Route, D> engine(MatrixDistance { distances },
+            numOfCities, config.parameters_);
+    return engine.run(randomGen, std::move(routes));
+}
+
+template<typename S, typename C, typename M, typename R>
+Solution withDuplicates(const DistanceMatrix& distances, const GeneticConfig& config,
+        RandomGenerator& randomGen, Population routes)
+{
+    if (config.duplicates_ == "keep")
+    {
+        return run<S, C, M, R, KeepDuplicates>(distances, config, randomGen, std::move(routes));
+    }
+    if (config.duplicates_ == "reject")
+    {
+        return run<S, C, M, R, RejectDuplicates>(distances, config, randomGen,
+                std::move(routes));
+    }
+    throwUnknown("duplicates", config.duplicates_);
+}
+
+template<typename S, typename C, typename M>
+Solution withReplacement(const DistanceMatrix& distances, const GeneticConfig& config,
+        RandomGenerator& randomGen, Population routes)
+{
+    if (config.replacement_ == "worstHalf")
+    {
+        return withDuplicates<S, C, M, ReplaceWorstHalf>(distances, config, randomGen,
+                std::move(routes));
+    }
+    if (config.replacement_ == "elitist")
+    {
+        return withDuplicates<S, C, M, ElitistReplacement>(distances, config, randomGen,
+                std::move(routes));
+    }
+    throwUnknown("replacement", config.replacement_);
+}
+
+template<typename S, typename C>
+Solution withMutation(const DistanceMatrix& distances, const GeneticConfig& config,
+        RandomGenerator& randomGen, Population routes)
+{
+    if (config.mutation_ == "swap")
+    {
+        return withReplacement<S, C, SwapMutation>(distances, config, randomGen,
+                std::move(routes));
+    }
+    if (config.mutation_ == "inversion")
+    {
+        return withReplacement<S, C, InversionMutation>(distances, config, randomGen,
+                std::move(routes));
+    }
+    throwUnknown("mutation", config.mutation_);
+}
+
+template<typename S>
+Solution withCrossover(const DistanceMatrix& distances, const GeneticConfig& config,
+        RandomGenerator& randomGen, Population routes)
+{
+    if (config.crossover_ == "order")
+    {
+        return withMutation<S, OrderCrossover>(distances, config, randomGen, std::move(routes));
+    }
+    if (config.crossover_ == "pmx")
+    {
+        return withMutation<S, PartiallyMappedCrossover>(distances, config, randomGen,
+                std::move(routes));
+    }
+    throwUnknown("crossover", config.crossover_);
+}
+
+}
+
+Solution solveGenetic(const DistanceMatrix& distances, const GeneticConfig& config,
+        RandomGenerator& randomGen, Population routes /*= Population(0)*/)
+{
+    if (config.selection_ == "truncation")
+    {
+        return withCrossover<TruncationSelection>(distances, config, randomGen,
+                std::move(routes));
+    }
+    if (config.selection_ == "tournament")
+    {
+        return withCrossover<TournamentSelection<3>>(distances, config, randomGen,
+                std::move(routes));
+    }
+    throwUnknown("selection", config.selection_);
+}
+
+std::vector<GeneticConfig> allGeneticConfigs(const GeneticParameters& parameters)
+{
+    std::vector<GeneticConfig> configs;
+    for (const auto selection : {"truncation", "tournament"})
+    {
+        for (const auto crossover : {"order", "pmx"})
+        {
+            for (const auto mutation : {"swap", "inversion"})
+            {
+                for (const auto replacement : {"worstHalf", "elitist"})
+                {
+                    for (const auto duplicates : {"keep", "reject"})
+                    {
+                        configs.push_back({selection, crossover, mutation, replacement,
+                                parameters, duplicates});
+                    }
+                }
+            }
+        }
+    }
+    return configs;
+}
@@ -0,0 +1,32 @@
+#ifndef GENETICCONFIG_HPP_
+#define GENETICCONFIG_HPP_
+
+#include "DistanceMatrix.hpp"
+#include "GeneticEngine.hpp"
+#include "TSP.hpp"
+
+#include <string>
+#include <vector>
+
+/*
+ * Runtime choice between the prebuilt GeneticEngine instantiations.
+ * Operators are picked by name once per run, the generation loop itself is fully static.
+ * Instances of up to 65536 cities run on 16-bit city indexes.
+ */
+struct GeneticConfig
+{
+    std::string selection_ = "truncation";   // truncation, tournament
+    std::string crossover_ = "order";        // order, pmx
+    std::string mutation_ = "swap";          // swap, inversion
+    std::string replacement_ = "worstHalf";  // worstHalf, elitist
+    GeneticParameters parameters_;
+    std::string duplicates_ = "keep";        // keep, reject
+};
+
+// Throws std::runtime_error on an unknown operator name
+Solution solveGenetic(const DistanceMatrix& distances, const GeneticConfig& config,
+        RandomGenerator& randomGen, Population routes = Population(0));
+
+std::vector<GeneticConfig> allGeneticConfigs(const GeneticParameters& parameters);
+
+#endif /* GENETICCONFIG_HPP_ */
@@ -0,0 +1,183 @@
+#ifndef GENETICENGINE_HPP_
+#define GENETICENGINE_HPP_
+
+#include "GeneticPolicies.hpp"
+#include "Telemetry.hpp"
+#include "TSP.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+struct GeneticParameters
+{
+    unsigned populationSize_ = 150;
+    long double mutationProbability_ = 0.01;
+    unsigned numOfGenerations_ = 200;
+};
+
+/*
+ * Generational genetic algorithm assembled from compile-time policies
+ * (see GeneticPolicies.hpp). Individuals carry their cost, so every route is evaluated
+ * once, when it is created. Offspring buffers are reused between generations.
+ * An engine is not thread-safe, use one per thread.
+ */
+template<typename Selection, typename Crossover, typename Mutation, typename Replacement,
+        typename Distance, typename R = Route,
+        typename Duplicates = GeneticPolicies::KeepDuplicates>
+class GeneticEngine
+{
+public:
+    using Result = BasicSolution<R>;
+    // Carries a hash only when the Duplicates policy keeps one
+    using Individual = typename Duplicates::template Individual<R>;
+    using Individuals = std::vector<Individual>;
+    using Routes = std::vector<R>;
+
+    GeneticEngine(Distance distance, const unsigned numOfCities,
+            const GeneticParameters& parameters)
+            : distance_ { std::move(distance) }, numOfCities_ { numOfCities },
+              parameters_ { parameters }
+    {}
+
+    // Evaluates given routes, random routes are generated when there are none
+    Individuals createPopulation(Routes routes, RandomGenerator& randomGen)
+    {
+        if (routes.empty())
+        {
+            R route { GeneticPolicies::RouteTraits<R>::identity(numOfCities_) };
+            for (auto i = 0U; i < parameters_.populationSize_; ++i)
+            {
+                std::shuffle(route.begin(), route.end(), randomGen);
+                routes.push_back(route);
+            }
+        }
+
+        Individuals population(routes.size());
+        for (auto i = 0U; i < routes.size(); ++i)
+        {
+            population[i].route_ = std::move(routes[i]);
+            population[i].cost_ = evaluate(population[i].route_);
+            duplicates_.hash(population[i]);
+        }
+        return population;
+    }
+
+    void step(Individuals& population, RandomGenerator& randomGen)
+    {
+        {
+            TELEMETRY_SCOPE(Telemetry::Phase::Sorting);
+            replacement_.prepare(population);
+            duplicates_.prepare(population);
+        }
+
+        offspring_.resize(replacement_.numOfOffspring(population.size()));
+        std::uniform_real_distribution<long double> distr(0, 1);
+        for (auto& child : offspring_)
+        {
+            GeneticPolicies::RouteTraits<R>::resize(child.route_, numOfCities_);
+            std::pair<unsigned, unsigned> parents;
+            {
+                TELEMETRY_SCOPE(Telemetry::Phase::Selection);
+                parents = selection_(population, randomGen);
+            }
+            {
+                TELEMETRY_SCOPE(Telemetry::Phase::Crossover);
+                crossover_(population[parents.first].route_, population[parents.second].route_,
+                        child.route_, randomGen);
+            }
+            duplicates_.hash(child);
+            if (distr(randomGen) <= parameters_.mutationProbability_)
+            {
+                TELEMETRY_SCOPE(Telemetry::Phase::Mutation);
+                mutation_(child.route_, randomGen, duplicates_.moves(child));
+            }
+            if (!duplicates_.admit(child))
+            {
+                // A clone would only crowd out a distinct tour, a random one is evaluated instead
+                std::shuffle(child.route_.begin(), child.route_.end(), randomGen);
+                duplicates_.hash(child);
+                duplicates_.admit(child);
+            }
+            child.cost_ = evaluate(child.route_);
+        }
+
+        const unsigned improvements = replacement_.replace(population, offspring_);
+#if TELEMETRY_ENABLED
+        std::vector<unsigned> costs(population.size());
+        std::transform(population.begin(), population.end(), costs.begin(),
+                [](const Individual& i){return i.cost_;});
+        TELEMETRY_GENERATION(costs, improvements);
+#else
+        (void)improvements;
+#endif
+    }
+
+    Result run(RandomGenerator& randomGen, Routes routes = Routes(0))
+    {
+        Individuals population { createPopulation(std::move(routes), randomGen) };
+        TELEMETRY_BEGIN_RUN();
+        for (auto i = 0U; i < parameters_.numOfGenerations_; ++i)
+        {
+            step(population, randomGen);
+        }
+        return fittest(population);
+    }
+
+    static Individual fittest(const Individuals& population)
+    {
+        return *std::min_element(population.begin(), population.end(),
+                [](const Individual& lhs, const Individual& rhs){return lhs.cost_ < rhs.cost_;});
+    }
+
+private:
+    unsigned evaluate(const R& route) const
+    {
+        TELEMETRY_SCOPE(Telemetry::Phase::Evaluation);
+        return distance_(route);
+    }
+
+    Distance distance_;
+    const unsigned numOfCities_;
+    const GeneticParameters parameters_;
+    Selection selection_;
+    Crossover crossover_;
+    Mutation mutation_;
+    Replacement replacement_;
+    Duplicates duplicates_;
+    Individuals offspring_;
+};
+
+// The operators TSP::genetic has always used
+template<typename City>
+using DefaultGeneticEngineOf = GeneticEngine<GeneticPolicies::TruncationSelection,
+        GeneticPolicies::OrderCrossover, GeneticPolicies::SwapMutation,
+        GeneticPolicies::ReplaceWorstHalf, GeneticPolicies::MatrixDistance, BasicRoute<City>>;
+using DefaultGeneticEngine = DefaultGeneticEngineOf<unsigned>;
+
+// Whether every city index of an instance fits in City
+template<typename City>
+constexpr bool fitsCityType(const unsigned numOfCities)
+{
+    return numOfCities == 0 || numOfCities - 1 <= std::numeric_limits<City>::max();
+}
+
+// Runs an engine working on narrower city indexes on regular routes
+template<typename Engine>
+Solution runOnRoutes(Engine& engine, RandomGenerator& randomGen, const Population& routes)
+{
+    typename Engine::Routes narrowed;
+    narrowed.reserve(routes.size());
+    for (const auto& route : routes)
+    {
+        narrowed.emplace_back(route.begin(), route.end());
+    }
+    const auto best = engine.run(randomGen, std::move(narrowed));
+    return {best.cost_, Route(best.route_.begin(), best.route_.end())};
+}
+
+#endif /* GENETICENGINE_HPP_ */
@@ -0,0 +1,209 @@
+#include "GeneticConfig.hpp"
+#include "GeneticEngine.hpp"
+#include "TSP.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+
+using testing::ElementsAre;
+
+namespace
+{
+
+bool isPermutation(Route route)
+{
+    Route expected(route.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(route.begin(), route.end());
+    return route == expected;
+}
+
+}
+
+class GeneticEngineFixture : public ::testing::Test
+{
+protected:
+    const TSP tsp_{"/home/dec/studia/sem6/zwsisk/swiss42.tsp"};
+    RandomGenerator randomGen_{11};
+};
+
+TEST_F(GeneticEngineFixture, crossoversProducePermutations)
+{
+    Route parent_a(42);
+    std::iota(parent_a.begin(), parent_a.end(), 0);
+    Route parent_b(parent_a.rbegin(), parent_a.rend());
+    Route offspring(42);
+    GeneticPolicies::OrderCrossover ox;
+    GeneticPolicies::PartiallyMappedCrossover pmx;
+    for (auto i = 0; i < 100; ++i)
+    {
+        ox(parent_a, parent_b, offspring, randomGen_);
+        ASSERT_TRUE(isPermutation(offspring));
+        pmx(parent_a, parent_b, offspring, randomGen_);
+        ASSERT_TRUE(isPermutation(offspring));
+    }
+}
+
+TEST_F(GeneticEngineFixture, mutationsKeepPermutations)
+{
+    Route route(42);
+    std::iota(route.begin(), route.end(), 0);
+    for (auto i = 0; i < 100; ++i)
+    {
+        GeneticPolicies::SwapMutation{}(route, randomGen_);
+        GeneticPolicies::InversionMutation{}(route, randomGen_);
+        ASSERT_TRUE(isPermutation(route));
+    }
+}
+
+TEST_F(GeneticEngineFixture, elitistReplacementKeepsCheapest)
+{
+    std::vector<Solution> population { {5, {}}, {1, {}}, {7, {}} };
+    std::vector<Solution> offspring { {2, {}}, {9, {}}, {3, {}} };
+    const unsigned improvements = GeneticPolicies::ElitistReplacement{}.replace(population,
+            offspring);
+    std::vector<unsigned> costs;
+    for (const auto& s : population)
+    {
+        costs.push_back(s.cost_);
+    }
+    std::sort(costs.begin(), costs.end());
+    ASSERT_THAT(costs, ElementsAre(1, 2, 3));
+    ASSERT_EQ(2, improvements);
+    ASSERT_EQ(3, offspring.size());
+}
+
+TEST_F(GeneticEngineFixture, cachedCostsMatchRoutes)
+{
+    DefaultGeneticEngine engine(GeneticPolicies::MatrixDistance { tsp_.getDistances() },
+            tsp_.getNumOfCities(), { 20, 0.5, 0 });
+    auto population = engine.createPopulation({}, randomGen_);
+    for (auto i = 0; i < 10; ++i)
+    {
+        engine.step(population, randomGen_);
+    }
+    ASSERT_EQ(20, population.size());
+    for (const auto& individual : population)
+    {
+        ASSERT_EQ(tsp_.calcCostOfRoute(individual.route_), individual.cost_);
+    }
+}
+
+TEST_F(GeneticEngineFixture, compactRoutesGiveSameResult)
+{
+    const GeneticParameters parameters { 30, 0.2, 50 };
+    const GeneticPolicies::MatrixDistance distance { tsp_.getDistances() };
+    RandomGenerator randomGen { randomGen_ };
+    DefaultGeneticEngine wide(distance, tsp_.getNumOfCities(), parameters);
+    DefaultGeneticEngineOf<std::uint16_t> compact(distance, tsp_.getNumOfCities(), parameters);
+    const Solution expected { wide.run(randomGen_) };
+    const Solution s { runOnRoutes(compact, randomGen, {}) };
+    ASSERT_EQ(expected.cost_, s.cost_);
+    ASSERT_EQ(expected.route_, s.route_);
+}
+
+TEST(CityTypeTest, fitsCityType)
+{
+    ASSERT_TRUE(fitsCityType<std::uint16_t>(65536));
+    ASSERT_FALSE(fitsCityType<std::uint16_t>(65537));
+    ASSERT_TRUE(fitsCityType<std::uint8_t>(0));
+}
+
+TEST_F(GeneticEngineFixture, edgeHashIgnoresRotationAndDirection)
+{
+    Route route(42);
+    std::iota(route.begin(), route.end(), 0);
+    std::shuffle(route.begin(), route.end(), randomGen_);
+    const GeneticPolicies::EdgeHash edgeHash;
+    const std::uint64_t hash { edgeHash(route) };
+
+    Route rotated(route);
+    std::rotate(rotated.begin(), rotated.begin() + 17, rotated.end());
+    ASSERT_EQ(hash, edgeHash(rotated));
+    ASSERT_EQ(hash, edgeHash(Route(route.rbegin(), route.rend())));
+
+    std::swap(route[3], route[20]);
+    ASSERT_NE(hash, edgeHash(route));
+}
+
+TEST_F(GeneticEngineFixture, edgeHashFollowsMoves)
+{
+    const GeneticPolicies::EdgeHash edgeHash;
+    for (const unsigned size : {3U, 4U, 5U, 42U})
+    {
+        Route route(size);
+        std::iota(route.begin(), route.end(), 0);
+        std::uint64_t hash { edgeHash(route) };
+        std::uniform_int_distribution<unsigned> distr(0, size - 1);
+        for (auto i = 0; i < 200; ++i)
+        {
+            unsigned first = distr(randomGen_);
+            unsigned last = distr(randomGen_);
+            hash = edgeHash.swapped(hash, route, first, last);
+            std::swap(route[first], route[last]);
+            ASSERT_EQ(edgeHash(route), hash);
+
+            first = distr(randomGen_);
+            last = distr(randomGen_);
+            if (last < first)
+            {
+                std::swap(first, last);
+            }
+            hash = edgeHash.reversed(hash, route, first, last);
+            std::reverse(route.begin() + first, route.begin() + last + 1);
+            ASSERT_EQ(edgeHash(route), hash);
+        }
+    }
+}
+
+// Hashes cost memory only when duplicates are rejected
+static_assert(std::is_same<DefaultGeneticEngineOf<std::uint16_t>::Individual,
+        BasicSolution<CompactRoute>>::value, "Kept duplicates need no hash");
+
+TEST_F(GeneticEngineFixture, rejectDuplicatesKeepsToursDistinct)
+{
+    GeneticEngine<GeneticPolicies::TruncationSelection, GeneticPolicies::OrderCrossover,
+            GeneticPolicies::InversionMutation, GeneticPolicies::ReplaceWorstHalf,
+            GeneticPolicies::MatrixDistance, Route, GeneticPolicies::RejectDuplicates> engine(
+            GeneticPolicies::MatrixDistance { tsp_.getDistances() }, tsp_.getNumOfCities(),
+            { 40, 0.5, 0 });
+    auto population = engine.createPopulation({}, randomGen_);
+    const GeneticPolicies::EdgeHash edgeHash;
+    for (auto i = 0; i < 300; ++i)
+    {
+        engine.step(population, randomGen_);
+    }
+    std::set<std::uint64_t> distinct;
+    for (const auto& individual : population)
+    {
+        ASSERT_EQ(edgeHash(individual.route_), individual.hash_);
+        ASSERT_EQ(tsp_.calcCostOfRoute(individual.route_), individual.cost_);
+        distinct.insert(individual.hash_);
+    }
+    ASSERT_EQ(population.size(), distinct.size());
+}
+
+TEST_F(GeneticEngineFixture, everyConfigFindsAValidRoute)
+{
+    for (const auto& config : allGeneticConfigs({ 20, 0.1, 10 }))
+    {
+        const Solution s { solveGenetic(tsp_.getDistances(), config, randomGen_) };
+        ASSERT_TRUE(isPermutation(s.route_));
+        ASSERT_EQ(tsp_.calcCostOfRoute(s.route_), s.cost_);
+    }
+}
+
+TEST_F(GeneticEngineFixture, throwsOnUnknownOperator)
+{
+    GeneticConfig config;
+    config.crossover_ = "witam";
+    ASSERT_THROW(solveGenetic(tsp_.getDistances(), config, randomGen_), std::runtime_error);
+}
@@ -0,0 +1,542 @@
+#ifndef GENETICPOLICIES_HPP_
+#define GENETICPOLICIES_HPP_
+
+#include "DistanceMatrix.hpp"
+#include "TSP.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/*
+ * Operators plugged into GeneticEngine. Every policy is a plain class the compiler can
+ * inline into the generation loop, routes are any random access container of cities.
+ * Policies may keep scratch buffers, so an instance must not be shared between threads.
+ */
+namespace GeneticPolicies
+{
+
+// Creating and sizing routes, for both heap (std::vector) and fixed size (std::array) routes
+template<typename R>
+struct RouteTraits;
+
+template<typename City>
+struct RouteTraits<std::vector<City>>
+{
+    static void resize(std::vector<City>& route, const unsigned numOfCities)
+    {
+        route.resize(numOfCities);
+    }
+
+    static std::vector<City> identity(const unsigned numOfCities)
+    {
+        std::vector<City> route(numOfCities);
+        std::iota(route.begin(), route.end(), 0);
+        return route;
+    }
+};
+
+template<typename City, std::size_t N>
+struct RouteTraits<std::array<City, N>>
+{
+    static void resize(std::array<City, N>&, const unsigned)
+    {}
+
+    static std::array<City, N> identity(const unsigned)
+    {
+        std::array<City, N> route;
+        std::iota(route.begin(), route.end(), 0);
+        return route;
+    }
+};
+
+// Selection: picks indices of two parents from a population whose fitter half is sorted
+
+// Picks two different individuals from the fitter half
+struct TruncationSelection
+{
+    template<typename Individuals>
+    std::pair<unsigned, unsigned> operator()(const Individuals& population,
+            RandomGenerator& randomGen) const
+    {
+        const unsigned size = population.size();
+        const unsigned alphaSize = size > 4 ? size / 2 : std::min(3U, size);
+        std::uniform_int_distribution<unsigned> distr(0, alphaSize - 1);
+
+        const unsigned parent_a = distr(randomGen);
+        unsigned parent_b = distr(randomGen);
+        while (alphaSize > 1 && parent_a == parent_b)
+        {
+            parent_b = distr(randomGen);
+        }
+        return {parent_a, parent_b};
+    }
+};
+
+// Each parent is the cheapest of TournamentSize individuals drawn from the whole population
+template<unsigned TournamentSize>
+struct TournamentSelection
+{
+    static_assert(TournamentSize > 0, "Tournament needs at least one contestant");
+
+    template<typename Individuals>
+    std::pair<unsigned, unsigned> operator()(const Individuals& population,
+            RandomGenerator& randomGen) const
+    {
+        return {pick(population, randomGen), pick(population, randomGen)};
+    }
+
+private:
+    template<typename Individuals>
+    unsigned pick(const Individuals& population, RandomGenerator& randomGen) const
+    {
+        std::uniform_int_distribution<unsigned> distr(0, population.size() - 1);
+        unsigned best = distr(randomGen);
+        for (auto i = 1U; i < TournamentSize; ++i)
+        {
+            const unsigned contestant = distr(randomGen);
+            if (population[contestant].cost_ < population[best].cost_)
+            {
+                best = contestant;
+            }
+        }
+        return best;
+    }
+};
+
+// Crossover: writes a child of two parents into a route of the same length
+
+// Copies a random slice of parent_a and fills the rest with the remaining cities
+// in the order they appear in parent_b
+class OrderCrossover
+{
+public:
+    template<typename R>
+    void operator()(const R& parent_a, const R& parent_b, R& offspring,
+            RandomGenerator& randomGen)
+    {
+        const unsigned size = parent_a.size();
+        std::uniform_int_distribution<unsigned> distr(0, size - 1);
+        const unsigned pivot_a = distr(randomGen);
+        unsigned pivot_b = distr(randomGen);
+        while (pivot_b < pivot_a)
+        {
+            pivot_b = distr(randomGen);
+        }
+
+        used_.assign(size, false);
+        for (auto i = pivot_a; i <= pivot_b; ++i)
+        {
+            offspring[i] = parent_a[i];
+            used_[parent_a[i]] = true;
+        }
+        unsigned j = 0;
+        for (auto i = 0U; i < size; ++i)
+        {
+            if ((i < pivot_a) || (i > pivot_b))
+            {
+                while (used_[parent_b[j]])
+                {
+                    ++j;
+                }
+                offspring[i] = parent_b[j];
+                used_[parent_b[j]] = true;
+            }
+        }
+    }
+
+private:
+    std::vector<char> used_;
+};
+
+// Partially mapped crossover: starts from parent_b and swaps the cities of a random
+// slice of parent_a into their positions
+class PartiallyMappedCrossover
+{
+public:
+    template<typename R>
+    void operator()(const R& parent_a, const R& parent_b, R& offspring,
+            RandomGenerator& randomGen)
+    {
+        const unsigned size = parent_a.size();
+        std::uniform_int_distribution<unsigned> distr(0, size - 1);
+        unsigned pivot_a = distr(randomGen);
+        unsigned pivot_b = distr(randomGen);
+        if (pivot_b < pivot_a)
+        {
+            std::swap(pivot_a, pivot_b);
+        }
+
+        offspring = parent_b;
+        position_.resize(size);
+        for (auto i = 0U; i < size; ++i)
+        {
+            position_[offspring[i]] = i;
+        }
+        for (auto i = pivot_a; i <= pivot_b; ++i)
+        {
+            const unsigned j = position_[parent_a[i]];
+            std::swap(position_[offspring[i]], position_[offspring[j]]);
+            std::swap(offspring[i], offspring[j]);
+        }
+    }
+
+private:
+    std::vector<unsigned> position_;
+};
+
+// Mutation: modifies a route in place. The move is reported to an observer before it is
+// applied, so route properties can be updated without a full pass over the route.
+
+// Observer of mutation moves that does nothing
+struct IgnoreMoves
+{
+    template<typename R>
+    void swapped(const R&, const unsigned, const unsigned) const
+    {}
+
+    template<typename R>
+    void reversed(const R&, const unsigned, const unsigned) const
+    {}
+};
+
+// Swaps two random cities
+struct SwapMutation
+{
+    template<typename R, typename Moves = IgnoreMoves>
+    void operator()(R& route, RandomGenerator& randomGen, Moves&& moves = Moves { }) const
+    {
+        std::uniform_int_distribution<unsigned> distr(0, route.size() - 1);
+        const unsigned i = distr(randomGen);
+        const unsigned j = distr(randomGen);
+        moves.swapped(route, i, j);
+        std::swap(route[i], route[j]);
+    }
+};
+
+// Reverses a random slice, i.e. a random 2-opt move
+struct InversionMutation
+{
+    template<typename R, typename Moves = IgnoreMoves>
+    void operator()(R& route, RandomGenerator& randomGen, Moves&& moves = Moves { }) const
+    {
+        std::uniform_int_distribution<unsigned> distr(0, route.size() - 1);
+        unsigned first = distr(randomGen);
+        unsigned last = distr(randomGen);
+        if (last < first)
+        {
+            std::swap(first, last);
+        }
+        moves.reversed(route, first, last);
+        std::reverse(route.begin() + first, route.begin() + last + 1);
+    }
+};
+
+// Replacement: prepare() sorts the population before selection, replace() merges the
+// offspring into it and returns how many of them displaced a more expensive individual
+
+template<typename Individuals>
+void sortFitterHalf(Individuals& population)
+{
+    using Individual = typename Individuals::value_type;
+    std::partial_sort(population.begin(), population.begin() + population.size() / 2,
+            population.end(), [](const Individual& lhs, const Individual& rhs)
+            {
+                return lhs.cost_ < rhs.cost_;
+            });
+}
+
+// Offspring take the places of the less fit half
+struct ReplaceWorstHalf
+{
+    unsigned numOfOffspring(const unsigned populationSize) const
+    {
+        return populationSize - populationSize / 2;
+    }
+
+    template<typename Individuals>
+    void prepare(Individuals& population) const
+    {
+        sortFitterHalf(population);
+    }
+
+    template<typename Individuals>
+    unsigned replace(Individuals& population, Individuals& offspring) const
+    {
+        unsigned improvements = 0U;
+        const unsigned first = population.size() / 2;
+        for (auto i = 0U; i < offspring.size(); ++i)
+        {
+            improvements += offspring[i].cost_ < population[first + i].cost_;
+            std::swap(population[first + i], offspring[i]);
+        }
+        return improvements;
+    }
+};
+
+// (mu + lambda): as many offspring as individuals, the cheapest of both survive
+struct ElitistReplacement
+{
+    unsigned numOfOffspring(const unsigned populationSize) const
+    {
+        return populationSize;
+    }
+
+    template<typename Individuals>
+    void prepare(Individuals& population) const
+    {
+        sortFitterHalf(population);
+    }
+
+    template<typename Individuals>
+    unsigned replace(Individuals& population, Individuals& offspring) const
+    {
+        const unsigned size = population.size();
+        std::move(offspring.begin(), offspring.end(), std::back_inserter(population));
+        std::vector<unsigned> order(population.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::nth_element(order.begin(), order.begin() + size, order.end(),
+                [&](const unsigned lhs, const unsigned rhs)
+                {
+                    return population[lhs].cost_ < population[rhs].cost_;
+                });
+
+        Individuals merged;
+        merged.reserve(order.size());
+        unsigned improvements = 0U;
+        for (auto i = 0U; i < order.size(); ++i)
+        {
+            improvements += i < size && order[i] >= size;
+            merged.push_back(std::move(population[order[i]]));
+        }
+        // Losers go back to offspring, their routes are reused as buffers
+        offspring.assign(std::make_move_iterator(merged.begin() + size),
+                std::make_move_iterator(merged.end()));
+        merged.resize(size);
+        population = std::move(merged);
+        return improvements;
+    }
+};
+
+// Tour identity: a tour is the set of its undirected edges, hashed as the XOR of
+// a pseudo-random key per edge (Zobrist hashing). Rotated and reversed copies of a tour
+// hash the same, and a swap or a reversal updates the hash in O(1).
+class EdgeHash
+{
+public:
+    explicit EdgeHash(const std::uint64_t seed = 0x9E3779B97F4A7C15ULL)
+            : seed_ { seed }
+    {}
+
+    // splitmix64 of the edge, computed on the fly instead of a table of n * n keys
+    std::uint64_t key(unsigned from, unsigned to) const
+    {
+        if (to < from)
+        {
+            std::swap(from, to);
+        }
+        std::uint64_t z = seed_ + ((std::uint64_t { from } << 32 | to) + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    template<typename R>
+    std::uint64_t operator()(const R& route) const
+    {
+        std::uint64_t hash = key(route[route.size() - 1], route[0]);
+        for (auto i = 1U; i < route.size(); ++i)
+        {
+            hash ^= key(route[i - 1], route[i]);
+        }
+        return hash;
+    }
+
+    // Hash after swapping the cities at positions i and j, route is not swapped yet
+    template<typename R>
+    std::uint64_t swapped(std::uint64_t hash, const R& route, const unsigned i,
+            const unsigned j) const
+    {
+        const unsigned size = route.size();
+        if (i == j)
+        {
+            return hash;
+        }
+        // Edge e joins positions e and e + 1, only the edges touching i and j change
+        unsigned edges[] = { (i + size - 1) % size, i, (j + size - 1) % size, j };
+        std::sort(std::begin(edges), std::end(edges));
+        const auto last = std::unique(std::begin(edges), std::end(edges));
+        const auto swappedCity = [&](const unsigned k)
+        {
+            return k == i ? route[j] : k == j ? route[i] : route[k];
+        };
+        for (auto e = std::begin(edges); e != last; ++e)
+        {
+            const unsigned next = (*e + 1) % size;
+            hash ^= key(route[*e], route[next]) ^ key(swappedCity(*e), swappedCity(next));
+        }
+        return hash;
+    }
+
+    // Hash after reversing positions first..last, route is not reversed yet
+    template<typename R>
+    std::uint64_t reversed(std::uint64_t hash, const R& route, const unsigned first,
+            const unsigned last) const
+    {
+        const unsigned size = route.size();
+        // Reversing all but at most one city of a cycle only changes its direction
+        if (last <= first || last - first + 2 >= size)
+        {
+            return hash;
+        }
+        const unsigned before = route[(first + size - 1) % size];
+        const unsigned after = route[(last + 1) % size];
+        return hash ^ key(before, route[first]) ^ key(route[last], after)
+                ^ key(before, route[last]) ^ key(route[first], after);
+    }
+
+private:
+    const std::uint64_t seed_;
+};
+
+// Duplicates: whether an offspring may join the population. hash() is called after
+// crossover, moves() observes the mutation and admit() decides. Individual<R> is what
+// the engine stores, with whatever the policy needs besides the route and its cost.
+
+struct KeepDuplicates
+{
+    template<typename R>
+    using Individual = BasicSolution<R>;
+
+    template<typename Individuals>
+    void prepare(const Individuals&) const
+    {}
+
+    template<typename Individual>
+    void hash(Individual&) const
+    {}
+
+    template<typename Individual>
+    IgnoreMoves moves(Individual&) const
+    {
+        return {};
+    }
+
+    template<typename Individual>
+    bool admit(const Individual&) const
+    {
+        return true;
+    }
+};
+
+// Solution with the hash of its tour
+template<typename R>
+struct HashedSolution : BasicSolution<R>
+{
+    std::uint64_t hash_ = 0U;
+};
+
+// Rejects offspring with the same tour as an individual of the population
+// or an earlier offspring of the same generation
+class RejectDuplicates
+{
+    class Tracker
+    {
+    public:
+        Tracker(const EdgeHash& edgeHash, std::uint64_t& hash)
+                : edgeHash_ { edgeHash }, hash_ { hash }
+        {}
+
+        template<typename R>
+        void swapped(const R& route, const unsigned i, const unsigned j)
+        {
+            hash_ = edgeHash_.swapped(hash_, route, i, j);
+        }
+
+        template<typename R>
+        void reversed(const R& route, const unsigned first, const unsigned last)
+        {
+            hash_ = edgeHash_.reversed(hash_, route, first, last);
+        }
+
+    private:
+        const EdgeHash& edgeHash_;
+        std::uint64_t& hash_;
+    };
+
+public:
+    template<typename R>
+    using Individual = HashedSolution<R>;
+
+    template<typename Individuals>
+    void prepare(const Individuals& population)
+    {
+        seen_.clear();
+        for (const auto& individual : population)
+        {
+            seen_.insert(individual.hash_);
+        }
+    }
+
+    template<typename Individual>
+    void hash(Individual& individual) const
+    {
+        individual.hash_ = edgeHash_(individual.route_);
+    }
+
+    template<typename Individual>
+    Tracker moves(Individual& individual) const
+    {
+        return {edgeHash_, individual.hash_};
+    }
+
+    template<typename Individual>
+    bool admit(const Individual& individual)
+    {
+        return seen_.insert(individual.hash_).second;
+    }
+
+private:
+    EdgeHash edgeHash_;
+    std::unordered_set<std::uint64_t> seen_;
+};
+
+// Distance providers: cost of a whole tour
+
+// Matrix is anything with an unsigned operator()(from, to), e.g. a mapped matrix file
+template<typename Matrix>
+class BasicMatrixDistance
+{
+public:
+    explicit BasicMatrixDistance(const Matrix& distances)
+            : distances_ { &distances }
+    {}
+
+    template<typename R>
+    unsigned operator()(const R& route) const
+    {
+        const Matrix& d = *distances_;
+        unsigned cost = d(route[route.size() - 1], route[0]);
+        for (auto i = 1U; i < route.size(); ++i)
+        {
+            cost += d(route[i - 1], route[i]);
+        }
+        return cost;
+    }
+
+private:
+    const Matrix* distances_;
+};
+
+using MatrixDistance = BasicMatrixDistance<DistanceMatrix>;
+
+}
+
+#endif /* GENETICPOLICIES_HPP_ */
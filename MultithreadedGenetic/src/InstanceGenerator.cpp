@@ -0,0 +1,305 @@
+#include "InstanceGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace InstanceGenerator
+{
+
+namespace
+{
+
+const char MAGIC[] = { 'Z', 'W', 'D', 'M' };
+constexpr std::uint32_t VERSION = 1;
+static_assert(sizeof(MAGIC) + 3 * sizeof(std::uint32_t) == HEADER_SIZE, "Header size changed");
+static_assert(sizeof(unsigned) == sizeof(std::uint32_t), "Weights are stored as u32");
+// Rows generated before they are written, about 16 MiB of weights
+constexpr std::size_t BLOCK_SIZE = 1U << 22;
+
+// Streams of the counter-based generator
+enum Stream : std::uint64_t { POINTS = 1, CENTRES, CLUSTERS, WEIGHTS };
+
+struct Point
+{
+    double x_ = 0.0;
+    double y_ = 0.0;
+};
+
+// splitmix64 finaliser
+std::uint64_t mix(std::uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t draw(const std::uint64_t seed, const Stream stream, const std::uint64_t index)
+{
+    return mix(mix(seed + stream * 0x9E3779B97F4A7C15ULL) + index * 0x9E3779B97F4A7C15ULL);
+}
+
+// Uniform in <0; 1)
+double uniform(const std::uint64_t seed, const Stream stream, const std::uint64_t index)
+{
+    return (draw(seed, stream, index) >> 11) * (1.0 / (1ULL << 53));
+}
+
+bool isLittleEndian()
+{
+    const std::uint32_t one = 1U;
+    char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+// Runs f(first, last) on numOfThreads contiguous parts of <first; last)
+template<typename Function>
+void parallelFor(const unsigned numOfThreads, const std::size_t first, const std::size_t last,
+        Function f)
+{
+    const std::size_t numOfParts = std::max<std::size_t>(1U,
+            std::min<std::size_t>(numOfThreads, last - first));
+    std::vector<std::future<void>> parts;
+    for (auto i = 0U; i < numOfParts; ++i)
+    {
+        const std::size_t begin = first + (last - first) * i / numOfParts;
+        const std::size_t end = first + (last - first) * (i + 1) / numOfParts;
+        parts.push_back(std::async(std::launch::async, [&f, begin, end](){f(begin, end);}));
+    }
+    for (auto& part : parts)
+    {
+        part.get();
+    }
+}
+
+// Weight of every pair of cities, computed on demand from the settings
+class Weights
+{
+public:
+    explicit Weights(const Settings& settings)
+            : settings_ { settings }
+    {
+        if (settings.numOfCities_ == 0 || (settings.kind_ == Kind::METRIC
+                ? settings.maxCost_ == 0 : settings.side_ == 0))
+        {
+            throw std::runtime_error { " * Instance needs cities and positive costs * " };
+        }
+        if (settings.kind_ != Kind::METRIC)
+        {
+            points_.resize(settings.numOfCities_);
+            parallelFor(settings.numOfThreads_, 0, points_.size(),
+                    [this](const std::size_t first, const std::size_t last)
+                    {
+                        for (auto city = first; city < last; ++city)
+                        {
+                            points_[city] = pointOf(city);
+                        }
+                    });
+        }
+    }
+
+    void fillRows(const unsigned first, const unsigned last, unsigned* rows) const
+    {
+        const unsigned n = settings_.numOfCities_;
+        for (auto from = first; from < last; ++from)
+        {
+            unsigned* row = rows + static_cast<std::size_t>(from - first) * n;
+            for (auto to = 0U; to < n; ++to)
+            {
+                row[to] = from == to ? 0U : weightOf(from, to);
+            }
+        }
+    }
+
+private:
+    Point pointOf(const std::uint64_t city) const
+    {
+        const double side = settings_.side_;
+        if (settings_.kind_ == Kind::UNIFORM)
+        {
+            return {uniform(settings_.seed_, POINTS, 2 * city) * side,
+                    uniform(settings_.seed_, POINTS, 2 * city + 1) * side};
+        }
+
+        const unsigned numOfClusters = settings_.numOfClusters_ ? settings_.numOfClusters_
+                : std::max(1U, static_cast<unsigned>(std::sqrt(settings_.numOfCities_)));
+        const std::uint64_t cluster = draw(settings_.seed_, CLUSTERS, city) % numOfClusters;
+        // Box-Muller transform of two uniforms, 1 - u keeps the logarithm finite
+        const double radius = std::sqrt(-2.0 * std::log(1.0
+                - uniform(settings_.seed_, POINTS, 2 * city)))
+                * static_cast<double>(settings_.clusterSpread_) * side;
+        const double angle = 2.0 * M_PI * uniform(settings_.seed_, POINTS, 2 * city + 1);
+        const double x = uniform(settings_.seed_, CENTRES, 2 * cluster) * side
+                + radius * std::cos(angle);
+        const double y = uniform(settings_.seed_, CENTRES, 2 * cluster + 1) * side
+                + radius * std::sin(angle);
+        return {std::min(std::max(x, 0.0), side), std::min(std::max(y, 0.0), side)};
+    }
+
+    unsigned weightOf(const unsigned from, const unsigned to) const
+    {
+        if (settings_.kind_ == Kind::METRIC)
+        {
+            // Drawn for the unordered pair, so the matrix is symmetric
+            const std::uint64_t pair { static_cast<std::uint64_t>(std::min(from, to))
+                    * settings_.numOfCities_ + std::max(from, to) };
+            const unsigned minCost = settings_.maxCost_ - settings_.maxCost_ / 2;
+            return minCost + draw(settings_.seed_, WEIGHTS, pair)
+                    % (settings_.maxCost_ - minCost + 1);
+        }
+        // Coordinates are bounded by side_, std::hypot's care for overflow isn't needed
+        const double dx = points_[from].x_ - points_[to].x_;
+        const double dy = points_[from].y_ - points_[to].y_;
+        return std::max(1U, static_cast<unsigned>(std::sqrt(dx * dx + dy * dy) + 0.5));
+    }
+
+    const Settings settings_;
+    std::vector<Point> points_;
+};
+
+void writeHeader(std::ostream& os, const unsigned numOfCities)
+{
+    if (!isLittleEndian())
+    {
+        throw std::runtime_error { " * Matrix files need a little-endian host * " };
+    }
+    const std::uint32_t header[] = { VERSION, numOfCities, 0U };
+    os.write(MAGIC, sizeof(MAGIC));
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+std::ofstream openForWriting(const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error { " * Couldn't open " + path + " * " };
+    }
+    return file;
+}
+
+}
+
+Kind parseKind(const std::string& name)
+{
+    if (name == "uniform")
+    {
+        return Kind::UNIFORM;
+    }
+    if (name == "clustered")
+    {
+        return Kind::CLUSTERED;
+    }
+    if (name == "metric")
+    {
+        return Kind::METRIC;
+    }
+    throw std::runtime_error { " * Unknown kind of instance: " + name + " * " };
+}
+
+DistanceMatrix generate(const Settings& settings)
+{
+    const Weights weights(settings);
+    const unsigned n = settings.numOfCities_;
+    std::vector<unsigned> matrix(static_cast<std::size_t>(n) * n);
+    parallelFor(settings.numOfThreads_, 0, n,
+            [&](const std::size_t first, const std::size_t last)
+            {
+                weights.fillRows(first, last, &matrix[first * n]);
+            });
+    return DistanceMatrix(n, std::move(matrix));
+}
+
+void writeFile(const std::string& path, const Settings& settings)
+{
+    const Weights weights(settings);
+    const unsigned n = settings.numOfCities_;
+    std::ofstream file { openForWriting(path) };
+    writeHeader(file, n);
+
+    const unsigned rowsPerBlock = std::max<std::size_t>(1U, BLOCK_SIZE / n);
+    std::vector<unsigned> block(static_cast<std::size_t>(std::min(rowsPerBlock, n)) * n);
+    for (auto first = 0U; first < n; first += rowsPerBlock)
+    {
+        const unsigned last = std::min(first + rowsPerBlock, n);
+        parallelFor(settings.numOfThreads_, first, last,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                    weights.fillRows(begin, end, &block[(begin - first) * n]);
+                });
+        file.write(reinterpret_cast<const char*>(block.data()),
+                static_cast<std::size_t>(last - first) * n * sizeof(unsigned));
+    }
+    if (!file.flush())
+    {
+        throw std::runtime_error { " * Couldn't write " + path + " * " };
+    }
+}
+
+void writeFile(const std::string& path, const DistanceMatrix& distances)
+{
+    const unsigned n = distances.getNumOfCities();
+    std::ofstream file { openForWriting(path) };
+    writeHeader(file, n);
+    std::vector<unsigned> row(n);
+    for (auto from = 0U; from < n; ++from)
+    {
+        for (auto to = 0U; to < n; ++to)
+        {
+            row[to] = distances(from, to);
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), n * sizeof(unsigned));
+    }
+    if (!file.flush())
+    {
+        throw std::runtime_error { " * Couldn't write " + path + " * " };
+    }
+}
+
+unsigned parseHeader(const char* header)
+{
+    std::uint32_t fields[3];
+    std::memcpy(fields, header + sizeof(MAGIC), sizeof(fields));
+    if (!std::equal(MAGIC, MAGIC + sizeof(MAGIC), header) || fields[0] != VERSION
+            || !isLittleEndian())
+    {
+        throw std::runtime_error { " * Not a matrix file * " };
+    }
+    return fields[1];
+}
+
+DistanceMatrix readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        throw std::runtime_error { " * Couldn't open " + path + " * " };
+    }
+    const auto size = file.tellg();
+    char header[HEADER_SIZE];
+    if (!file.seekg(0) || !file.read(header, sizeof(header)))
+    {
+        throw std::runtime_error { " * Not a matrix file: " + path + " * " };
+    }
+    const unsigned n = parseHeader(header);
+    // Checked before allocating, a corrupted header mustn't ask for gigabytes
+    if (static_cast<std::uint64_t>(size) != HEADER_SIZE
+            + static_cast<std::uint64_t>(n) * n * sizeof(unsigned))
+    {
+        throw std::runtime_error { " * Truncated matrix file: " + path + " * " };
+    }
+    std::vector<unsigned> matrix(static_cast<std::size_t>(n) * n);
+    if (!file.read(reinterpret_cast<char*>(matrix.data()), matrix.size() * sizeof(unsigned)))
+    {
+        throw std::runtime_error { " * Truncated matrix file: " + path + " * " };
+    }
+    return DistanceMatrix(n, std::move(matrix));
+}
+
+}
@@ -0,0 +1,65 @@
+#ifndef INSTANCEGENERATOR_HPP_
+#define INSTANCEGENERATOR_HPP_
+
+#include "DistanceMatrix.hpp"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/*
+ * Reproducible synthetic instances for scale testing. Every point and every weight is
+ * a pure function of the seed and its indices (a counter-based generator), so rows can
+ * be filled by any number of threads in any order and the instance depends on nothing
+ * but the settings.
+ *
+ * Binary matrix file, little-endian, laid out to be memory-mapped:
+ *   "ZWDM" u32 version, u32 numOfCities, u32 reserved, then numOfCities^2 u32 weights
+ *   row by row
+ */
+namespace InstanceGenerator
+{
+
+enum class Kind
+{
+    UNIFORM,    // points spread uniformly over a square
+    CLUSTERED,  // points normally distributed around uniformly spread centres
+    METRIC      // random weights that satisfy the triangle inequality, no geometry
+};
+
+struct Settings
+{
+    Kind kind_ = Kind::UNIFORM;
+    unsigned numOfCities_ = 1000;
+    std::uint64_t seed_ = 0U;
+    // Points lie in a square of that side, weights are rounded Euclidean distances, at least 1
+    unsigned side_ = 100000;
+    unsigned numOfClusters_ = 0U;  // 0 for the square root of numOfCities_
+    // Standard deviation of a city from its cluster's centre, as a fraction of side_
+    long double clusterSpread_ = 0.02;
+    // METRIC weights are drawn from <maxCost_ - maxCost_ / 2; maxCost_>, no weight
+    // exceeds the sum of two others, so every triangle holds
+    unsigned maxCost_ = 1000;
+    unsigned numOfThreads_ = std::thread::hardware_concurrency();
+};
+
+// Throws std::runtime_error on a name other than uniform, clustered or metric
+Kind parseKind(const std::string& name);
+
+// All of them throw std::runtime_error on settings without cities or costs
+DistanceMatrix generate(const Settings& settings);
+// Generates and writes a block of rows at a time, the whole matrix is never in memory
+void writeFile(const std::string& path, const Settings& settings);
+void writeFile(const std::string& path, const DistanceMatrix& distances);
+// Throws std::runtime_error on anything that isn't a complete matrix file
+DistanceMatrix readFile(const std::string& path);
+
+// Size of the header preceding the weights in a matrix file
+constexpr unsigned HEADER_SIZE = 16;
+// Number of cities in the HEADER_SIZE bytes of a header, for files mapped into memory.
+// Throws std::runtime_error if they aren't a header this version can read.
+unsigned parseHeader(const char* header);
+
+}
+
+#endif /* INSTANCEGENERATOR_HPP_ */
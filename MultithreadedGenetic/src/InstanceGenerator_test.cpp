@@ -0,0 +1,119 @@
+#include "InstanceGenerator.hpp"
+#include "TemporaryFile.hpp"
+#include "TSP.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+bool equal(const DistanceMatrix& lhs, const DistanceMatrix& rhs)
+{
+    if (lhs.getNumOfCities() != rhs.getNumOfCities())
+    {
+        return false;
+    }
+    for (auto from = 0U; from < lhs.getNumOfCities(); ++from)
+    {
+        for (auto to = 0U; to < lhs.getNumOfCities(); ++to)
+        {
+            if (lhs(from, to) != rhs(from, to))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+class InstanceGeneratorFixture : public ::testing::Test
+{
+protected:
+    const TemporaryFile file_ { "instance_generator_test" };
+    const std::string& path_ { file_.getPath() };
+};
+
+TEST(InstanceGenerator, givesSameInstanceForAnyNumOfThreads)
+{
+    using InstanceGenerator::Kind;
+    for (const Kind kind : {Kind::UNIFORM, Kind::CLUSTERED, Kind::METRIC})
+    {
+        InstanceGenerator::Settings settings;
+        settings.kind_ = kind;
+        settings.numOfCities_ = 60;
+        settings.seed_ = 4;
+        settings.numOfThreads_ = 1;
+        const DistanceMatrix serial { InstanceGenerator::generate(settings) };
+        settings.numOfThreads_ = 7;
+        ASSERT_TRUE(equal(serial, InstanceGenerator::generate(settings)));
+        settings.seed_ = 5;
+        ASSERT_FALSE(equal(serial, InstanceGenerator::generate(settings)));
+
+        for (auto from = 0U; from < 60; ++from)
+        {
+            ASSERT_EQ(0U, serial(from, from));
+            for (auto to = from + 1; to < 60; ++to)
+            {
+                ASSERT_GT(serial(from, to), 0U);
+                ASSERT_EQ(serial(from, to), serial(to, from));
+            }
+        }
+    }
+}
+
+TEST(InstanceGenerator, metricWeightsSatisfyTriangleInequality)
+{
+    InstanceGenerator::Settings settings;
+    settings.kind_ = InstanceGenerator::parseKind("metric");
+    settings.numOfCities_ = 30;
+    settings.maxCost_ = 99;
+    const DistanceMatrix d { InstanceGenerator::generate(settings) };
+    for (auto a = 0U; a < 30; ++a)
+    {
+        for (auto b = 0U; b < 30; ++b)
+        {
+            for (auto c = 0U; c < 30; ++c)
+            {
+                ASSERT_LE(d(a, c), d(a, b) + d(b, c));
+            }
+        }
+    }
+    ASSERT_THROW(InstanceGenerator::parseKind("gaussian"), std::runtime_error);
+    settings.numOfCities_ = 0;
+    ASSERT_THROW(InstanceGenerator::generate(settings), std::runtime_error);
+}
+
+TEST_F(InstanceGeneratorFixture, writesFileInBlocks)
+{
+    // More rows than fit in one block
+    InstanceGenerator::Settings settings;
+    settings.kind_ = InstanceGenerator::Kind::CLUSTERED;
+    settings.numOfCities_ = 2100;
+    InstanceGenerator::writeFile(path_, settings);
+    const DistanceMatrix generated { InstanceGenerator::generate(settings) };
+    ASSERT_TRUE(equal(generated, InstanceGenerator::readFile(path_)));
+
+    settings.numOfCities_ = 40;
+    const DistanceMatrix small { InstanceGenerator::generate(settings) };
+    InstanceGenerator::writeFile(path_, small);
+    const TSP tsp(InstanceGenerator::readFile(path_));
+    ASSERT_EQ(40U, tsp.getNumOfCities());
+    ASSERT_EQ(small(3, 7), tsp.getCostBetweenCities(7, 3));
+    const Solution s { tsp.genetic(20, 0.1, 20) };
+    ASSERT_EQ(tsp.calcCostOfRoute(s.route_), s.cost_);
+
+    std::ofstream(path_, std::ios::binary | std::ios::trunc) << "ZWDM";
+    ASSERT_THROW(InstanceGenerator::readFile(path_), std::runtime_error);
+
+    // Header of 65535 cities, 16 GiB of weights, followed by a few bytes
+    std::ofstream(path_, std::ios::binary | std::ios::trunc)
+            << std::string("ZWDM\x01\0\0\0\xFF\xFF\0\0\0\0\0\0", 16) << "weights";
+    ASSERT_THROW(InstanceGenerator::readFile(path_), std::runtime_error);
+}
@@ -0,0 +1,510 @@
+#include "ProcessIslands.hpp"
+#include "InstanceGenerator.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ProcessIslands
+{
+
+namespace
+{
+
+constexpr std::size_t CACHE_LINE = MigrationRing::CACHE_LINE;
+
+std::size_t alignedSize(const std::size_t size)
+{
+    return (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+std::runtime_error systemError(const std::string& what)
+{
+    return std::runtime_error { " * " + what + ": " + std::strerror(errno) + " * " };
+}
+
+// Best route of an island, valid once done_ is set. Its cities follow it.
+struct Result
+{
+    std::atomic<std::uint32_t> done_;
+    std::uint32_t cost_;
+};
+
+/*
+ * POSIX shared memory segment of the coordinator: a counter of migrants, then a ring and
+ * a result per island. Its name is removed as soon as it exists, workers are handed the
+ * descriptor, so nothing is left behind whichever of the processes dies.
+ */
+class Segment
+{
+public:
+    // Creates the segment when fd is negative, maps the coordinator's one otherwise
+    Segment(const unsigned numOfIslands, const unsigned ringCapacity,
+            const unsigned numOfCities, const int fd = -1)
+            : numOfIslands_ { numOfIslands }, ringCapacity_ { ringCapacity },
+              numOfCities_ { numOfCities },
+              ringSize_ { alignedSize(MigrationRing::sizeFor(ringCapacity, numOfCities)) },
+              resultSize_ { alignedSize(sizeof(Result) + numOfCities * sizeof(std::uint32_t)) },
+              size_ { CACHE_LINE + numOfIslands * (ringSize_ + resultSize_) }, fd_ { fd }
+    {
+        if (fd_ >= 0)
+        {
+            struct stat status;
+            if (fstat(fd_, &status) != 0 || static_cast<std::size_t>(status.st_size) != size_)
+            {
+                throw std::runtime_error { " * Segment doesn't match the settings * " };
+            }
+            map();
+            return;
+        }
+
+        static std::atomic<unsigned> numOfSegments { 0U };
+        const std::string name { "/zwsisk_islands_" + std::to_string(getpid()) + "_"
+                + std::to_string(numOfSegments++) };
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd_ < 0)
+        {
+            throw systemError("Couldn't create " + name);
+        }
+        shm_unlink(name.c_str());
+        if (ftruncate(fd_, size_) != 0)
+        {
+            close(fd_);
+            throw systemError("Couldn't size " + name);
+        }
+        map();
+
+        new (data_) std::atomic<std::uint64_t>(0U);
+        for (auto island = 0U; island < numOfIslands_; ++island)
+        {
+            MigrationRing::initialize(ringMemory(island));
+            new (&result(island).done_) std::atomic<std::uint32_t>(0U);
+        }
+    }
+
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+
+    ~Segment()
+    {
+        munmap(data_, size_);
+        close(fd_);
+    }
+
+    int getFd() const
+    {
+        return fd_;
+    }
+
+    std::atomic<std::uint64_t>& numOfMigrants()
+    {
+        return *reinterpret_cast<std::atomic<std::uint64_t>*>(data_);
+    }
+
+    MigrationRing ring(const unsigned island)
+    {
+        return MigrationRing(ringMemory(island), ringCapacity_, numOfCities_);
+    }
+
+    Result& result(const unsigned island)
+    {
+        return *reinterpret_cast<Result*>(resultMemory(island));
+    }
+
+    std::uint32_t* cities(const unsigned island)
+    {
+        return reinterpret_cast<std::uint32_t*>(resultMemory(island) + sizeof(Result));
+    }
+
+private:
+    // Closes the descriptor when the mapping fails
+    void map()
+    {
+        void* data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (data == MAP_FAILED)
+        {
+            const auto error = systemError("Couldn't map segment");
+            close(fd_);
+            throw error;
+        }
+        data_ = static_cast<char*>(data);
+    }
+
+    char* ringMemory(const unsigned island)
+    {
+        return data_ + CACHE_LINE + island * ringSize_;
+    }
+
+    char* resultMemory(const unsigned island)
+    {
+        return data_ + CACHE_LINE + numOfIslands_ * ringSize_ + island * resultSize_;
+    }
+
+    const unsigned numOfIslands_;
+    const unsigned ringCapacity_;
+    const unsigned numOfCities_;
+    const std::size_t ringSize_;
+    const std::size_t resultSize_;
+    const std::size_t size_;
+    int fd_;
+    char* data_ = nullptr;
+};
+
+// Sends the island's best routes on and replaces its worst ones with cheaper migrants
+template<typename Individuals>
+void migrate(Individuals& population, MigrationRing& in, MigrationRing& out,
+        const unsigned numOfMigrants, Segment& segment)
+{
+    using Individual = typename Individuals::value_type;
+    const auto cheaper = [](const Individual& lhs, const Individual& rhs)
+    {
+        return lhs.cost_ < rhs.cost_;
+    };
+    const unsigned numOfSent = std::min<std::size_t>(numOfMigrants, population.size());
+    std::partial_sort(population.begin(), population.begin() + numOfSent, population.end(),
+            cheaper);
+    for (auto i = 0U; i < numOfSent; ++i)
+    {
+        out.push(population[i].cost_, population[i].route_);
+    }
+
+    Individual migrant;
+    unsigned numOfReceived = 0U;
+    while (in.pop(migrant.cost_, migrant.route_))
+    {
+        ++numOfReceived;
+        auto worst = std::max_element(population.begin(), population.end(), cheaper);
+        if (migrant.cost_ < worst->cost_)
+        {
+            std::swap(*worst, migrant);
+        }
+    }
+    segment.numOfMigrants().fetch_add(numOfReceived, std::memory_order_relaxed);
+}
+
+template<typename City>
+void evolveIsland(const Settings& settings, const MappedMatrix& matrix, Segment& segment,
+        const unsigned island, const unsigned numOfIslands, const std::uint64_t seed)
+{
+    using Engine = GeneticEngine<GeneticPolicies::TruncationSelection,
+            GeneticPolicies::OrderCrossover, GeneticPolicies::SwapMutation,
+            GeneticPolicies::ReplaceWorstHalf, MappedDistance, BasicRoute<City>>;
+    Engine engine(MappedDistance { matrix }, matrix.getNumOfCities(), settings.parameters_);
+    RandomGenerator randomGen { seed };
+    auto population = engine.createPopulation({}, randomGen);
+    MigrationRing in { segment.ring(island) };
+    MigrationRing out { segment.ring((island + 1) % numOfIslands) };
+
+    for (auto generation = 1U; generation <= settings.parameters_.numOfGenerations_;
+            ++generation)
+    {
+        engine.step(population, randomGen);
+        if (settings.migrationInterval_ && generation % settings.migrationInterval_ == 0
+                && numOfIslands > 1)
+        {
+            migrate(population, in, out, settings.numOfMigrants_, segment);
+        }
+    }
+
+    const auto best = Engine::fittest(population);
+    Result& result = segment.result(island);
+    result.cost_ = best.cost_;
+    std::copy(best.route_.begin(), best.route_.end(), segment.cities(island));
+    result.done_.store(1U, std::memory_order_release);
+}
+
+// Body of a worker process: its islands run on threads of their own
+void work(const Settings& settings, const MappedMatrix& matrix, Segment& segment,
+        const unsigned process, const std::vector<std::uint64_t>& seeds)
+{
+    const unsigned numOfIslands = seeds.size();
+    const bool compact = fitsCityType<std::uint16_t>(matrix.getNumOfCities());
+    std::vector<std::thread> islands;
+    for (auto i = 0U; i < settings.numOfIslandsPerProcess_; ++i)
+    {
+        const unsigned island = process * settings.numOfIslandsPerProcess_ + i;
+        islands.emplace_back([&, island, compact]()
+                {
+                    if (compact)
+                    {
+                        evolveIsland<std::uint16_t>(settings, matrix, segment, island,
+                                numOfIslands, seeds[island]);
+                    }
+                    else
+                    {
+                        evolveIsland<unsigned>(settings, matrix, segment, island,
+                                numOfIslands, seeds[island]);
+                    }
+                });
+    }
+    for (auto& island : islands)
+    {
+        island.join();
+    }
+}
+
+std::vector<std::uint64_t> seedsOf(const std::uint64_t seed, const unsigned numOfIslands)
+{
+    RandomGenerator randomGen { seed };
+    std::vector<std::uint64_t> seeds(numOfIslands);
+    std::generate(seeds.begin(), seeds.end(), std::ref(randomGen));
+    return seeds;
+}
+
+// Command line of a worker, after the program and WORKER_MODE
+std::vector<std::string> argumentsOf(const Settings& settings, const int fd,
+        const unsigned process)
+{
+    std::ostringstream mutationProbability;
+    mutationProbability.precision(std::numeric_limits<long double>::max_digits10);
+    mutationProbability << settings.parameters_.mutationProbability_;
+    return {std::to_string(fd), std::to_string(process), settings.matrixPath_,
+            std::to_string(settings.numOfProcesses_),
+            std::to_string(settings.numOfIslandsPerProcess_),
+            std::to_string(settings.parameters_.populationSize_), mutationProbability.str(),
+            std::to_string(settings.parameters_.numOfGenerations_),
+            std::to_string(settings.migrationInterval_), std::to_string(settings.numOfMigrants_),
+            std::to_string(settings.ringCapacity_), std::to_string(settings.seed_)};
+}
+
+// Starts this program again in WORKER_MODE, the segment's descriptor stays open in it
+pid_t spawnWorker(const std::vector<std::string>& arguments, const int fd)
+{
+    std::vector<std::string> command { "/proc/self/exe", WORKER_MODE };
+    command.insert(command.end(), arguments.begin(), arguments.end());
+    std::vector<char*> argv;
+    for (auto& argument : command)
+    {
+        argv.push_back(&argument[0]);
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    // Duplicating a descriptor onto itself clears its FD_CLOEXEC in the new process
+    posix_spawn_file_actions_adddup2(&actions, fd, fd);
+    pid_t pid = -1;
+    const int error = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    return error == 0 ? pid : -1;
+}
+
+}
+
+MappedMatrix::MappedMatrix(const std::string& path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw systemError("Couldn't open " + path);
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        throw systemError("Couldn't stat " + path);
+    }
+    size_ = status.st_size;
+    if (size_ < InstanceGenerator::HEADER_SIZE)
+    {
+        close(fd);
+        throw std::runtime_error { " * Not a matrix file: " + path + " * " };
+    }
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data_ == MAP_FAILED)
+    {
+        throw systemError("Couldn't map " + path);
+    }
+
+    const char* bytes = static_cast<const char*>(data_);
+    try
+    {
+        numOfCities_ = InstanceGenerator::parseHeader(bytes);
+    }
+    catch (...)
+    {
+        munmap(data_, size_);
+        throw;
+    }
+    if (size_ != InstanceGenerator::HEADER_SIZE
+            + static_cast<std::size_t>(numOfCities_) * numOfCities_ * sizeof(unsigned))
+    {
+        munmap(data_, size_);
+        throw std::runtime_error { " * Truncated matrix file: " + path + " * " };
+    }
+    weights_ = reinterpret_cast<const unsigned*>(bytes + InstanceGenerator::HEADER_SIZE);
+}
+
+MappedMatrix::~MappedMatrix()
+{
+    munmap(data_, size_);
+}
+
+unsigned MappedMatrix::getNumOfCities() const
+{
+    return numOfCities_;
+}
+
+std::size_t MigrationRing::sizeFor(const unsigned capacity, const unsigned numOfCities)
+{
+    // Clamped like the constructor's, so a ring never reaches past its memory
+    return sizeof(Control) + static_cast<std::size_t>(std::max(capacity, 1U))
+            * (numOfCities + 1) * sizeof(std::uint32_t);
+}
+
+void MigrationRing::initialize(void* memory)
+{
+    Control* control = new (memory) Control;
+    control->head_.store(0U);
+    control->tail_.store(0U);
+}
+
+MigrationRing::MigrationRing(void* memory, const unsigned capacity, const unsigned numOfCities)
+        : control_ { static_cast<Control*>(memory) },
+          slots_ { reinterpret_cast<std::uint32_t*>(static_cast<char*>(memory)
+                  + sizeof(Control)) },
+          capacity_ { std::max(capacity, 1U) }, numOfCities_ { numOfCities }
+{}
+
+Summary run(const Settings& settings)
+{
+    const MappedMatrix matrix(settings.matrixPath_);
+    Settings s { settings };
+    s.numOfProcesses_ = std::max(settings.numOfProcesses_, 1U);
+    s.numOfIslandsPerProcess_ = std::max(settings.numOfIslandsPerProcess_, 1U);
+    s.ringCapacity_ = std::max(settings.ringCapacity_, 1U);
+    const unsigned numOfIslands = s.numOfProcesses_ * s.numOfIslandsPerProcess_;
+    Segment segment(numOfIslands, s.ringCapacity_, matrix.getNumOfCities());
+
+    Summary summary;
+    std::vector<pid_t> workers;
+    for (auto process = 0U; process < s.numOfProcesses_; ++process)
+    {
+        const pid_t pid = spawnWorker(argumentsOf(s, segment.getFd(), process),
+                segment.getFd());
+        if (pid < 0)
+        {
+            ++summary.numOfFailedProcesses_;
+            continue;
+        }
+        workers.push_back(pid);
+    }
+
+    // Workers still running at the deadline are killed, their islands are lost
+    const auto deadline = std::chrono::steady_clock::now()
+            + std::chrono::seconds(s.timeoutSeconds_);
+    while (!workers.empty())
+    {
+        for (auto pid = workers.begin(); pid != workers.end();)
+        {
+            int status = 0;
+            const pid_t finished = waitpid(*pid, &status, WNOHANG);
+            if (finished == 0 || (finished < 0 && errno == EINTR))
+            {
+                ++pid;
+                continue;
+            }
+            summary.numOfFailedProcesses_ += finished < 0 || !WIFEXITED(status)
+                    || WEXITSTATUS(status) != 0;
+            pid = workers.erase(pid);
+        }
+        if (!workers.empty() && s.timeoutSeconds_
+                && std::chrono::steady_clock::now() >= deadline)
+        {
+            for (const pid_t pid : workers)
+            {
+                kill(pid, SIGKILL);
+                while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR)
+                {}
+            }
+            summary.numOfFailedProcesses_ += workers.size();
+            workers.clear();
+        }
+        if (!workers.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    for (auto island = 0U; island < numOfIslands; ++island)
+    {
+        const Result& result = segment.result(island);
+        if (!result.done_.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+        if (summary.numOfFinishedIslands_++ == 0 || result.cost_ < summary.best_.cost_)
+        {
+            summary.best_.cost_ = result.cost_;
+            const std::uint32_t* cities = segment.cities(island);
+            summary.best_.route_.assign(cities, cities + matrix.getNumOfCities());
+        }
+    }
+    if (summary.numOfFinishedIslands_ == 0)
+    {
+        throw std::runtime_error { " * No island finished * " };
+    }
+    summary.numOfMigrants_ = segment.numOfMigrants().load();
+    return summary;
+}
+
+int runWorker(const std::vector<std::string>& arguments)
+{
+    try
+    {
+        if (arguments.size() != 12)
+        {
+            throw std::runtime_error { " * Invalid arguments of a worker * " };
+        }
+        Settings settings;
+        settings.matrixPath_ = arguments[2];
+        settings.numOfProcesses_ = std::stoul(arguments[3]);
+        settings.numOfIslandsPerProcess_ = std::stoul(arguments[4]);
+        settings.parameters_.populationSize_ = std::stoul(arguments[5]);
+        settings.parameters_.mutationProbability_ = std::stold(arguments[6]);
+        settings.parameters_.numOfGenerations_ = std::stoul(arguments[7]);
+        settings.migrationInterval_ = std::stoul(arguments[8]);
+        settings.numOfMigrants_ = std::stoul(arguments[9]);
+        settings.ringCapacity_ = std::stoul(arguments[10]);
+        settings.seed_ = std::stoull(arguments[11]);
+        const unsigned process = std::stoul(arguments[1]);
+        const unsigned numOfIslands = settings.numOfProcesses_ * settings.numOfIslandsPerProcess_;
+        if (process >= settings.numOfProcesses_ || settings.numOfIslandsPerProcess_ == 0
+                || settings.ringCapacity_ == 0)
+        {
+            throw std::runtime_error { " * Invalid arguments of a worker * " };
+        }
+
+        const MappedMatrix matrix(settings.matrixPath_);
+        Segment segment(numOfIslands, settings.ringCapacity_, matrix.getNumOfCities(),
+                std::stoi(arguments[0]));
+        work(settings, matrix, segment, process, seedsOf(settings.seed_, numOfIslands));
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
+
+}
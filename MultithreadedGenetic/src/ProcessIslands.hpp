@@ -0,0 +1,157 @@
+#ifndef PROCESSISLANDS_HPP_
+#define PROCESSISLANDS_HPP_
+
+#include "GeneticEngine.hpp"
+#include "GeneticPolicies.hpp"
+#include "TSP.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Island search spread over local processes, each of them a failure domain and an
+ * allocator of its own. A coordinator creates a POSIX shared memory segment and starts
+ * the workers by running its own program again in WORKER_MODE (Linux's /proc/self/exe),
+ * so callers may have threads of their own. Every process maps the instance's matrix file
+ * (see InstanceGenerator.hpp), they all read the same pages of weights.
+ * Islands form a ring: every migrationInterval_ generations an island sends its best
+ * routes to the next island and takes in what the previous one sent. The coordinator
+ * waits for the workers and collects the best route of every island that finished,
+ * islands of a crashed or killed worker are lost but the search goes on without them.
+ * Results aren't reproducible, migrants arrive whenever their senders get to them.
+ */
+namespace ProcessIslands
+{
+
+// Read-only shared mapping of a matrix file, lookups are unchecked like DistanceMatrix's
+class MappedMatrix
+{
+public:
+    // Throws std::runtime_error if the file isn't a complete matrix file
+    explicit MappedMatrix(const std::string& path);
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+    ~MappedMatrix();
+
+    unsigned operator()(const unsigned from, const unsigned to) const
+    {
+        return weights_[static_cast<std::size_t>(from) * numOfCities_ + to];
+    }
+
+    unsigned getNumOfCities() const;
+
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0U;
+    const unsigned* weights_ = nullptr;
+    unsigned numOfCities_ = 0U;
+};
+
+using MappedDistance = GeneticPolicies::BasicMatrixDistance<MappedMatrix>;
+
+/*
+ * Lock-free single-producer single-consumer ring of routes in shared memory. A slot is
+ * plain u32s, the cost followed by the cities, so the same records can be sent between
+ * hosts later. push() drops the route when the ring is full, nobody waits for a migrant.
+ */
+class MigrationRing
+{
+public:
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Counters shared between processes");
+
+    // Bytes of a ring, its memory has to be aligned to CACHE_LINE
+    static std::size_t sizeFor(const unsigned capacity, const unsigned numOfCities);
+    // Makes an empty ring, once, before any process uses it
+    static void initialize(void* memory);
+
+    MigrationRing(void* memory, const unsigned capacity, const unsigned numOfCities);
+
+    template<typename R>
+    bool push(const unsigned cost, const R& route)
+    {
+        const std::uint64_t tail = control_->tail_.load(std::memory_order_relaxed);
+        if (tail - control_->head_.load(std::memory_order_acquire) >= capacity_)
+        {
+            return false;
+        }
+        std::uint32_t* slot = slotAt(tail);
+        slot[0] = cost;
+        std::copy(route.begin(), route.end(), slot + 1);
+        control_->tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename R>
+    bool pop(unsigned& cost, R& route)
+    {
+        const std::uint64_t head = control_->head_.load(std::memory_order_relaxed);
+        if (head == control_->tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        const std::uint32_t* slot = slotAt(head);
+        cost = slot[0];
+        route.assign(slot + 1, slot + 1 + numOfCities_);
+        control_->head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    static constexpr std::size_t CACHE_LINE = 64;
+
+private:
+    // Producer and consumer counters on separate cache lines
+    struct Control
+    {
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> head_;
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> tail_;
+    };
+
+    std::uint32_t* slotAt(const std::uint64_t index) const
+    {
+        return slots_ + index % capacity_ * (numOfCities_ + 1);
+    }
+
+    Control* control_;
+    std::uint32_t* slots_;
+    const unsigned capacity_;
+    const unsigned numOfCities_;
+};
+
+struct Settings
+{
+    std::string matrixPath_;
+    unsigned numOfProcesses_ = 2;
+    unsigned numOfIslandsPerProcess_ = 1;
+    GeneticParameters parameters_;
+    unsigned migrationInterval_ = 20;  // generations between migrations, 0 for none
+    unsigned numOfMigrants_ = 2;       // best routes an island sends every migration
+    unsigned ringCapacity_ = 16;
+    std::uint64_t seed_ = 0U;
+    // Workers still running after that many seconds are killed and fail, 0 for no limit
+    unsigned timeoutSeconds_ = 600;
+};
+
+struct Summary
+{
+    Solution best_;
+    unsigned numOfFinishedIslands_ = 0U;
+    unsigned numOfFailedProcesses_ = 0U;
+    // Migrants taken in by all islands
+    unsigned long long numOfMigrants_ = 0U;
+};
+
+// Runs the coordinator, throws std::runtime_error if no island finished
+Summary run(const Settings& settings);
+
+// First argument of a worker's command line, main hands the rest to runWorker()
+constexpr char WORKER_MODE[] = "--islands-worker";
+// Runs the islands of one worker, returns its exit status
+int runWorker(const std::vector<std::string>& arguments);
+
+}
+
+#endif /* PROCESSISLANDS_HPP_ */
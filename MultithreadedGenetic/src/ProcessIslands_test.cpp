@@ -0,0 +1,118 @@
+#include "InstanceGenerator.hpp"
+#include "ProcessIslands.hpp"
+#include "TemporaryFile.hpp"
+#include "TSP.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+class ProcessIslandsFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        InstanceGenerator::Settings settings;
+        settings.kind_ = InstanceGenerator::Kind::CLUSTERED;
+        settings.numOfCities_ = 50;
+        settings.seed_ = 8;
+        InstanceGenerator::writeFile(path_, settings);
+    }
+
+    const TemporaryFile file_ { "process_islands_test" };
+    const std::string& path_ { file_.getPath() };
+};
+
+TEST(MigrationRing, dropsRoutesWhenFull)
+{
+    alignas(ProcessIslands::MigrationRing::CACHE_LINE) unsigned char memory[1024];
+    ASSERT_LE(ProcessIslands::MigrationRing::sizeFor(3, 4), sizeof(memory));
+    ProcessIslands::MigrationRing::initialize(memory);
+    ProcessIslands::MigrationRing ring(memory, 3, 4);
+
+    unsigned cost = 0U;
+    Route route;
+    ASSERT_FALSE(ring.pop(cost, route));
+    for (auto i = 0U; i < 3; ++i)
+    {
+        ASSERT_TRUE(ring.push(10 + i, Route { i, 1, 2, 3 }));
+    }
+    ASSERT_FALSE(ring.push(20, Route { 0, 1, 2, 3 }));
+    for (auto i = 0U; i < 3; ++i)
+    {
+        ASSERT_TRUE(ring.pop(cost, route));
+        ASSERT_EQ(10 + i, cost);
+        ASSERT_EQ((Route { i, 1, 2, 3 }), route);
+    }
+    ASSERT_FALSE(ring.pop(cost, route));
+    ASSERT_TRUE(ring.push(30, CompactRoute { 3, 2, 1, 0 }));
+    ASSERT_TRUE(ring.pop(cost, route));
+    ASSERT_EQ((Route { 3, 2, 1, 0 }), route);
+}
+
+TEST_F(ProcessIslandsFixture, mapsMatrixFile)
+{
+    const ProcessIslands::MappedMatrix mapped(path_);
+    const DistanceMatrix read { InstanceGenerator::readFile(path_) };
+    ASSERT_EQ(50U, mapped.getNumOfCities());
+    for (auto from = 0U; from < 50; ++from)
+    {
+        for (auto to = 0U; to < 50; ++to)
+        {
+            ASSERT_EQ(read(from, to), mapped(from, to));
+        }
+    }
+    ASSERT_THROW(ProcessIslands::MappedMatrix("/nonexistent.bin"), std::runtime_error);
+}
+
+TEST_F(ProcessIslandsFixture, collectsBestOfWorkerProcesses)
+{
+    ProcessIslands::Settings settings;
+    settings.matrixPath_ = path_;
+    settings.numOfProcesses_ = 2;
+    settings.numOfIslandsPerProcess_ = 2;
+    settings.parameters_ = { 30, 0.1, 60 };
+    settings.migrationInterval_ = 5;
+    const ProcessIslands::Summary summary { ProcessIslands::run(settings) };
+    ASSERT_EQ(4U, summary.numOfFinishedIslands_);
+    ASSERT_EQ(0U, summary.numOfFailedProcesses_);
+    ASSERT_GT(summary.numOfMigrants_, 0U);
+
+    const TSP tsp(InstanceGenerator::readFile(path_));
+    ASSERT_EQ(tsp.calcCostOfRoute(summary.best_.route_), summary.best_.cost_);
+    Route route { summary.best_.route_ };
+    Route expected(50);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(route.begin(), route.end());
+    ASSERT_EQ(expected, route);
+}
+
+TEST_F(ProcessIslandsFixture, runsWithRingsOfNoCapacity)
+{
+    ASSERT_EQ(ProcessIslands::MigrationRing::sizeFor(1, 50),
+            ProcessIslands::MigrationRing::sizeFor(0, 50));
+    ProcessIslands::Settings settings;
+    settings.matrixPath_ = path_;
+    settings.numOfIslandsPerProcess_ = 2;
+    settings.parameters_ = { 30, 0.1, 60 };
+    settings.migrationInterval_ = 5;
+    settings.ringCapacity_ = 0;
+    const ProcessIslands::Summary summary { ProcessIslands::run(settings) };
+    ASSERT_EQ(4U, summary.numOfFinishedIslands_);
+    ASSERT_EQ(0U, summary.numOfFailedProcesses_);
+    const TSP tsp(InstanceGenerator::readFile(path_));
+    ASSERT_EQ(tsp.calcCostOfRoute(summary.best_.route_), summary.best_.cost_);
+}
+
+TEST_F(ProcessIslandsFixture, killsWorkersPastTimeout)
+{
+    ProcessIslands::Settings settings;
+    settings.matrixPath_ = path_;
+    settings.parameters_ = { 30, 0.1, 100000000 };
+    settings.timeoutSeconds_ = 1;
+    ASSERT_THROW(ProcessIslands::run(settings), std::runtime_error);
+}
@@ -1,14 +1,19 @@
 #ifndef PROJECTUTILITIES_HPP_
 #define PROJECTUTILITIES_HPP_
 
+#include "Affinity.hpp"
 #include "TSP.hpp"
 
-#include <atomic>
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
+#include <initializer_list>
 #include <future>
 #include <iostream>
 #include <mutex>
 #include <thread>
+#include <utility>
 #include <vector>
 
 using Clock = std::chrono::high_resolution_clock;
@@ -35,7 +40,8 @@ void printContainer(const T& cont)
     std::cout << std::endl;
 }
 
-// Measures average execution time of given function
+// Measures average execution time of given function.
+// The first call is a warmup (cold caches, lazy allocations) and is not counted.
 template<typename T, typename Lambda>
 long double measureAverageTime(const unsigned numOfTests, Lambda&& f)
 {
@@ -43,7 +49,8 @@ long double measureAverageTime(const unsigned numOfTests, Lambda&& f)
     {
         return 0.0;
     }
-    unsigned times { 0 };
+    f();
+    long double times { 0.0 };
     for (unsigned i = 0; i < numOfTests; ++i)
     {
         auto start = Clock::now();
@@ -51,7 +58,7 @@ long double measureAverageTime(const unsigned numOfTests, Lambda&& f)
         auto end = Clock::now();
         times += std::chrono::duration<long double, T>(end - start).count();
     }
-    return static_cast<long double>(times) / static_cast<long double>(numOfTests);
+    return times / static_cast<long double>(numOfTests);
 }
 
 // Measures average genetic execution time
@@ -82,88 +89,188 @@ long double measureAverageBruteForceTime(const unsigned numOfTests, const TSP& t
     return measureAverageTime<Milli>(numOfTests, [&](){return tsp.bruteForce();});
 }
 
-/*
- * Calculates error of funtion "f2" relative to function "f1".
- * Only function f2 is launched multiple times in parallel.
- * Function f1 is launched only once (created to measure error relative to brute force).
- */
-template<typename Lambda, typename Lambda2>
-long double measureAverageRelativeError(const int numOfTests, Lambda&& f1,
-        Lambda2&& f2)
+// Sums collected by a single experiment worker, padded so workers never share a cache line.
+// std::allocator doesn't honour over-alignment before C++17, so a whole line of padding
+// follows the sums wherever the vector of them starts.
+struct ExperimentAccumulator
 {
-    unsigned numOfThreads = std::thread::hardware_concurrency();
-    while (numOfTests % numOfThreads)
+    long double sumOfCosts_ = 0.0;
+    long double sumOfMillis_ = 0.0;
+    unsigned long long numOfRuns_ = 0U;
+    char padding_[64];
+
+    void add(const ExperimentAccumulator& rhs)
     {
-        --numOfThreads;
+        sumOfCosts_ += rhs.sumOfCosts_;
+        sumOfMillis_ += rhs.sumOfMillis_;
+        numOfRuns_ += rhs.numOfRuns_;
     }
 
-    std::atomic<unsigned> sumOfF2Costs { 0U };
-    auto f2Tester = [&]()
+    long double averageCost() const
     {
-        for (unsigned i = 0; i < numOfTests / numOfThreads; ++i)
-        {
-            sumOfF2Costs += f2().cost_;
-        }
-    };
+        return numOfRuns_ ? sumOfCosts_ / numOfRuns_ : 0.0;
+    }
 
-    std::vector<std::thread> threads(numOfThreads);
-    for (auto& t : threads)
+    long double averageMillis() const
     {
-        t = std::thread { f2Tester };
+        return numOfRuns_ ? sumOfMillis_ / numOfRuns_ : 0.0;
     }
+};
 
-    const long double f1Cost = f1().cost_;
+struct ExperimentResult
+{
+    ExperimentAccumulator reference_;
+    ExperimentAccumulator tested_;
 
-    for (auto& t : threads)
+    long double relativeError() const
     {
-        t.join();
+        const long double referenceCost = reference_.averageCost();
+        return std::abs(referenceCost - tested_.averageCost()) / referenceCost;
     }
+};
 
-    long double averageF2Cost { static_cast<long double>(sumOfF2Costs.load())
-            / static_cast<long double>(numOfTests) };
-    return std::abs((f1Cost - averageF2Cost)) / f1Cost;
-}
+// Where the workers of runExperimentInParallel run
+struct ExperimentPlacement
+{
+    // Index of the available CPU the first worker is pinned to, the next ones follow
+    unsigned firstCpu_ = 0U;
+    // Functions starting threads of their own run one at a time on every available CPU,
+    // a pinned worker would confine their threads to its single CPU
+    bool startsThreads_ = false;
+};
 
 /*
- * Calculates error of funtion "f2" relative to function "f1".
- * Both of them are launched multiple times in parallel
+ * Runs every function in "fs" numOfTests times in total, spread over worker threads
+ * pinned to consecutive CPUs. Each worker keeps its own accumulators, they are reduced
+ * once all workers are joined.
  */
-template<typename Lambda, typename Lambda2>
-long double measureAverageRelativeError_multi(const int numOfTests, Lambda&& f1,
-        Lambda2&& f2)
+template<typename... Lambdas>
+std::array<ExperimentAccumulator, sizeof...(Lambdas)> runExperimentInParallel(
+        const ExperimentPlacement& placement, const unsigned numOfTests, Lambdas&&... fs)
 {
-    unsigned numOfThreads = std::thread::hardware_concurrency();
-    while (numOfTests % numOfThreads)
-    {
-        --numOfThreads;
-    }
+    constexpr std::size_t numOfFunctions = sizeof...(Lambdas);
+    using Accumulators = std::array<ExperimentAccumulator, numOfFunctions>;
+
+    const std::vector<unsigned> cpus { Affinity::availableCpus() };
+    const unsigned numOfCpus = cpus.size() - std::min<std::size_t>(placement.firstCpu_,
+            cpus.size());
+    const unsigned numOfThreads = placement.startsThreads_ ? 1U
+            : std::max(1U, std::min(numOfTests, numOfCpus));
+    std::vector<Accumulators> local(numOfThreads);
 
-    std::atomic<unsigned> sumOfF1Costs { 0U };
-    std::atomic<unsigned> sumOfF2Costs { 0U };
-    auto mGen = [&]()
+    auto worker = [&](const unsigned id)
     {
-        for (unsigned i = 0; i < numOfTests / numOfThreads; ++i)
+        if (!placement.startsThreads_)
+        {
+            Affinity::pinCurrentThreadToCpu(cpus[(placement.firstCpu_ + id) % cpus.size()]);
+        }
+        const unsigned numOfRuns = numOfTests / numOfThreads + (id < numOfTests % numOfThreads);
+        Accumulators& acc = local[id];
+        for (unsigned i = 0; i < numOfRuns; ++i)
         {
-            sumOfF1Costs += f1().cost_;
-            sumOfF2Costs += f2().cost_;
+            std::size_t f = 0;
+            auto measure = [&](auto& function)
+            {
+                const auto start = Clock::now();
+                const long double cost = function().cost_;
+                const auto end = Clock::now();
+                acc[f].sumOfCosts_ += cost;
+                acc[f].sumOfMillis_ += std::chrono::duration<long double, Milli>(end - start).count();
+                ++acc[f].numOfRuns_;
+                ++f;
+            };
+            (void)std::initializer_list<int>{ (measure(fs), 0)... };
         }
     };
 
-    std::vector<std::thread> threads(numOfThreads);
-    for (auto& t : threads)
+    std::vector<std::thread> threads;
+    for (unsigned id = 0; id < numOfThreads; ++id)
     {
-        t = std::thread { mGen };
+        threads.emplace_back(worker, id);
     }
-
     for (auto& t : threads)
     {
         t.join();
     }
 
-    const long double f1Cost { static_cast<long double>(sumOfF1Costs.load())
-            / static_cast<long double>(numOfTests) };
-    const long double f2Cost { static_cast<long double>(sumOfF2Costs.load())
-            / static_cast<long double>(numOfTests) };
+    Accumulators total;
+    for (const auto& acc : local)
+    {
+        for (std::size_t f = 0; f < numOfFunctions; ++f)
+        {
+            total[f].add(acc[f]);
+        }
+    }
+    return total;
+}
+
+template<typename... Lambdas>
+std::array<ExperimentAccumulator, sizeof...(Lambdas)> runExperimentInParallel(
+        const unsigned numOfTests, Lambdas&&... fs)
+{
+    return runExperimentInParallel(ExperimentPlacement(), numOfTests,
+            std::forward<Lambdas>(fs)...);
+}
+
+/*
+ * Runs reference function "f1" once and function "f2" numOfTests times in parallel.
+ * With isolateReference f1 runs alone before the f2 workers start, otherwise it runs
+ * concurrently with them on a CPU of its own and both timings are affected by the
+ * contention for memory.
+ */
+template<typename Lambda, typename Lambda2>
+ExperimentResult runExperiment(const unsigned numOfTests, Lambda&& f1, Lambda2&& f2,
+        const bool isolateReference = true)
+{
+    ExperimentResult result;
+    auto runReference = [&]()
+    {
+        result.reference_ = runExperimentInParallel(1, f1)[0];
+    };
+
+    if (isolateReference)
+    {
+        runReference();
+        result.tested_ = runExperimentInParallel(numOfTests, f2)[0];
+    }
+    else
+    {
+        // The reference keeps the first CPU, tested workers start from the second one
+        std::thread reference { runReference };
+        ExperimentPlacement tested;
+        tested.firstCpu_ = 1;
+        result.tested_ = runExperimentInParallel(tested, numOfTests, f2)[0];
+        reference.join();
+    }
+    return result;
+}
+
+/*
+ * Calculates error of funtion "f2" relative to function "f1".
+ * Only function f2 is launched multiple times in parallel.
+ * Function f1 is launched only once (created to measure error relative to brute force).
+ */
+template<typename Lambda, typename Lambda2>
+long double measureAverageRelativeError(const int numOfTests, Lambda&& f1,
+        Lambda2&& f2, const bool isolateReference = true)
+{
+    return runExperiment(numOfTests, f1, f2, isolateReference).relativeError();
+}
+
+/*
+ * Calculates error of funtion "f2" relative to function "f1".
+ * Both of them are launched multiple times in parallel, f1 before f2, so neither
+ * competes with the other for CPUs.
+ */
+template<typename Lambda, typename Lambda2>
+long double measureAverageRelativeError_multi(const int numOfTests, Lambda&& f1,
+        Lambda2&& f2, const ExperimentPlacement& f1Placement = ExperimentPlacement(),
+        const ExperimentPlacement& f2Placement = ExperimentPlacement())
+{
+    const long double f1Cost { runExperimentInParallel(f1Placement, numOfTests, f1)[0]
+            .averageCost() };
+    const long double f2Cost { runExperimentInParallel(f2Placement, numOfTests, f2)[0]
+            .averageCost() };
     return std::abs((f2Cost - f1Cost)) / f2Cost;
 }
 
@@ -185,10 +292,13 @@ long double measureGeneticErrorRelativeToMulti(const unsigned numOfTests, const
         const unsigned populationSize, const long double mutationProbability,
         const unsigned numberOfGenerations)
 {
+    ExperimentPlacement multi;
+    multi.startsThreads_ = true;
     return measureAverageRelativeError_multi(numOfTests,
             [&](){return tsp.genetic_multi(populationSize, mutationProbability,
                     numberOfGenerations);},
-            [&](){return tsp.genetic(populationSize, mutationProbability, numberOfGenerations);}
+            [&](){return tsp.genetic(populationSize, mutationProbability, numberOfGenerations);},
+            multi
     );
 }
 
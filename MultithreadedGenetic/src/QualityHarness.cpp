@@ -0,0 +1,276 @@
+#include "QualityHarness.hpp"
+#include "GeneticConfig.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <future>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace QualityHarness
+{
+
+namespace
+{
+
+struct Sample
+{
+    long double gap_ = 0.0;
+    long double millis_ = 0.0;
+};
+
+long double mean(const std::vector<long double>& samples)
+{
+    return std::accumulate(samples.begin(), samples.end(), 0.0L) / samples.size();
+}
+
+}
+
+std::vector<Instance> readInstances(const std::string& directory)
+{
+    std::ifstream file(directory + "/optima.txt");
+    if (!file)
+    {
+        throw std::runtime_error { " * Couldn't open " + directory + "/optima.txt * " };
+    }
+
+    std::vector<Instance> instances;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream ss(line);
+        Instance instance;
+        std::string fileName;
+        if (line.empty() || line[0] == '#' || !(ss >> fileName >> instance.optimum_))
+        {
+            continue;
+        }
+        instance.name_ = fileName.substr(0, fileName.rfind('.'));
+        instance.path_ = directory + "/" + fileName;
+        instances.push_back(std::move(instance));
+    }
+    return instances;
+}
+
+std::vector<Solver> defaultSolvers(const unsigned populationSize,
+        const long double mutationProbability, const unsigned numOfIslands)
+{
+    std::vector<Solver> solvers;
+    solvers.push_back({"genetic",
+            [=](const TSP& tsp, const unsigned budget, RandomGenerator& randomGen)
+            {
+                return tsp.genetic(populationSize, mutationProbability, budget, randomGen);
+            }});
+    solvers.push_back({"genetic_reject",
+            [=](const TSP& tsp, const unsigned budget, RandomGenerator& randomGen)
+            {
+                GeneticConfig config;
+                config.parameters_ = { populationSize, mutationProbability, budget };
+                config.duplicates_ = "reject";
+                return solveGenetic(tsp.getDistances(), config, randomGen);
+            }});
+    solvers.push_back({"genetic_multi",
+            [=](const TSP& tsp, const unsigned budget, RandomGenerator& randomGen)
+            {
+                return tsp.genetic_multi(populationSize, mutationProbability, budget,
+                        numOfIslands, randomGen);
+            }});
+    solvers.back().numOfThreads_ = numOfIslands;
+    solvers.push_back({"genetic_steady",
+            [=](const TSP& tsp, const unsigned budget, RandomGenerator& randomGen)
+            {
+                return tsp.genetic_steady(populationSize, mutationProbability, budget,
+                        numOfIslands, randomGen);
+            }});
+    solvers.back().numOfThreads_ = numOfIslands;
+    solvers.push_back({"genetic_adaptive",
+            [=](const TSP& tsp, const unsigned budget, RandomGenerator& randomGen)
+            {
+                return tsp.genetic_adaptive(populationSize, budget, randomGen);
+            }});
+    solvers.push_back({"bruteForce",
+            [](const TSP& tsp, const unsigned, RandomGenerator&)
+            {
+                return tsp.bruteForce();
+            }, false, 11});
+    return solvers;
+}
+
+long double confidence95(const std::vector<long double>& samples)
+{
+    // Two-sided Student's t quantiles for 1..30 degrees of freedom
+    static const long double t[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+            2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+    const auto n = samples.size();
+    if (n < 2)
+    {
+        return 0.0;
+    }
+    const long double m = mean(samples);
+    long double squares = 0.0;
+    for (const auto s : samples)
+    {
+        squares += (s - m) * (s - m);
+    }
+    const long double stddev = std::sqrt(squares / (n - 1));
+    const long double quantile = n - 1 <= 30 ? t[n - 2] : 1.96;
+    return quantile * stddev / std::sqrt(static_cast<long double>(n));
+}
+
+std::vector<Point> run(const std::vector<Instance>& instances, const std::vector<Solver>& solvers,
+        const Settings& settings)
+{
+    std::vector<std::unique_ptr<TSP>> tsps;
+    for (const auto& instance : instances)
+    {
+        tsps.push_back(std::make_unique<TSP>(instance.path_));
+    }
+
+    using Key = std::tuple<unsigned, unsigned, unsigned>; // instance, solver, budget
+    std::map<Key, std::vector<std::future<Sample>>> futures;
+    std::vector<std::packaged_task<Sample()>> multithreaded;
+    {
+        ThreadPool pool(settings.numOfThreads_);
+        for (auto i = 0U; i < instances.size(); ++i)
+        {
+            for (auto s = 0U; s < solvers.size(); ++s)
+            {
+                if (tsps[i]->getNumOfCities() > solvers[s].maxNumOfCities_)
+                {
+                    continue;
+                }
+                const std::vector<unsigned> budgets { solvers[s].usesBudget_ ?
+                        settings.budgets_ : std::vector<unsigned>{0} };
+                for (const auto budget : budgets)
+                {
+                    for (auto seed = 0U; seed < settings.numOfSeeds_; ++seed)
+                    {
+                        const TSP* tsp = tsps[i].get();
+                        const Solver* solver = &solvers[s];
+                        const unsigned optimum = instances[i].optimum_;
+                        auto task = [=]()
+                        {
+                            RandomGenerator randomGen { seed };
+                            const auto start = std::chrono::steady_clock::now();
+                            const Solution solution { solver->solve_(*tsp, budget, randomGen) };
+                            const auto end = std::chrono::steady_clock::now();
+                            return Sample {
+                                (static_cast<long double>(solution.cost_) - optimum) / optimum,
+                                std::chrono::duration<long double, std::milli>(end - start).count()
+                            };
+                        };
+                        if (solver->numOfThreads_ > 1)
+                        {
+                            multithreaded.emplace_back(task);
+                            futures[Key{i, s, budget}].push_back(
+                                    multithreaded.back().get_future());
+                        }
+                        else
+                        {
+                            futures[Key{i, s, budget}].push_back(pool.submit(task));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (auto& task : multithreaded)
+    {
+        task();
+    }
+
+    std::vector<Point> points;
+    for (auto& entry : futures)
+    {
+        std::vector<long double> gaps;
+        std::vector<long double> millis;
+        for (auto& f : entry.second)
+        {
+            const Sample sample { f.get() };
+            gaps.push_back(sample.gap_);
+            millis.push_back(sample.millis_);
+        }
+        Point point;
+        point.instance_ = instances[std::get<0>(entry.first)].name_;
+        point.solver_ = solvers[std::get<1>(entry.first)].name_;
+        point.budget_ = std::get<2>(entry.first);
+        point.numOfSeeds_ = gaps.size();
+        point.meanGap_ = mean(gaps);
+        point.gapConfidence_ = confidence95(gaps);
+        point.meanMillis_ = mean(millis);
+        point.millisConfidence_ = confidence95(millis);
+        points.push_back(std::move(point));
+    }
+    return points;
+}
+
+long double timeToTarget(const std::vector<Point>& points, const std::string& instance,
+        const std::string& solver, const long double targetGap)
+{
+    std::vector<Point> curve;
+    std::copy_if(points.begin(), points.end(), std::back_inserter(curve),
+            [&](const Point& p){return p.instance_ == instance && p.solver_ == solver;});
+    std::sort(curve.begin(), curve.end(),
+            [](const Point& lhs, const Point& rhs){return lhs.meanMillis_ < rhs.meanMillis_;});
+
+    for (auto i = 0U; i < curve.size(); ++i)
+    {
+        if (curve[i].meanGap_ <= targetGap)
+        {
+            if (i == 0 || curve[i - 1].meanGap_ == curve[i].meanGap_)
+            {
+                return curve[i].meanMillis_;
+            }
+            const Point& before = curve[i - 1];
+            const long double fraction = (before.meanGap_ - targetGap)
+                    / (before.meanGap_ - curve[i].meanGap_);
+            return before.meanMillis_ + fraction * (curve[i].meanMillis_ - before.meanMillis_);
+        }
+    }
+    return std::numeric_limits<long double>::infinity();
+}
+
+void writeCsv(std::ostream& os, const std::vector<Point>& points)
+{
+    os << "instance,solver,budget,seeds,mean_gap,gap_ci95,mean_ms,ms_ci95\n";
+    for (const auto& p : points)
+    {
+        os << p.instance_ << ',' << p.solver_ << ',' << p.budget_ << ',' << p.numOfSeeds_ << ','
+                << p.meanGap_ << ',' << p.gapConfidence_ << ',' << p.meanMillis_ << ','
+                << p.millisConfidence_ << '\n';
+    }
+}
+
+void writeTimeToTarget(std::ostream& os, const std::vector<Point>& points,
+        const long double targetGap)
+{
+    std::vector<std::pair<std::string, std::string>> curves;
+    for (const auto& p : points)
+    {
+        const auto curve = std::make_pair(p.instance_, p.solver_);
+        if (std::find(curves.begin(), curves.end(), curve) == curves.end())
+        {
+            curves.push_back(curve);
+        }
+    }
+
+    os << "instance,solver,target_gap,time_to_target_ms\n";
+    for (const auto& c : curves)
+    {
+        os << c.first << ',' << c.second << ',' << targetGap << ','
+                << timeToTarget(points, c.first, c.second, targetGap) << '\n';
+    }
+}
+
+}
@@ -0,0 +1,85 @@
+#ifndef QUALITYHARNESS_HPP_
+#define QUALITYHARNESS_HPP_
+
+#include "TSP.hpp"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Runs solvers over TSPLIB instances with known optima and reports gap to the optimum
+ * versus wall time, with 95% confidence intervals over seeds.
+ *
+ * An instance directory contains the .tsp files and "optima.txt" with lines
+ *   <file name> <optimal tour cost>
+ */
+namespace QualityHarness
+{
+
+struct Instance
+{
+    std::string name_;
+    std::string path_;
+    unsigned optimum_ = 0U;
+};
+
+struct Solver
+{
+    std::string name_;
+    // Budget is the number of generations, solvers that don't use it are run once per seed
+    std::function<Solution(const TSP&, const unsigned budget, RandomGenerator&)> solve_;
+    bool usesBudget_ = true;
+    unsigned maxNumOfCities_ = -1;
+    // Threads a run keeps busy, runs of more than one don't share the CPUs with other runs
+    unsigned numOfThreads_ = 1;
+};
+
+struct Settings
+{
+    std::vector<unsigned> budgets_ { 25, 50, 100, 200, 400 };
+    unsigned numOfSeeds_ = 10;
+    unsigned numOfThreads_ = std::thread::hardware_concurrency();
+    long double targetGap_ = 0.05;
+};
+
+struct Point
+{
+    std::string instance_;
+    std::string solver_;
+    unsigned budget_ = 0U;
+    unsigned numOfSeeds_ = 0U;
+    long double meanGap_ = 0.0;
+    long double gapConfidence_ = 0.0;
+    long double meanMillis_ = 0.0;
+    long double millisConfidence_ = 0.0;
+};
+
+std::vector<Instance> readInstances(const std::string& directory);
+
+// genetic, genetic rejecting duplicates, genetic_multi, genetic_steady (numOfIslands
+// workers), genetic_adaptive and brute force (up to 11 cities)
+std::vector<Solver> defaultSolvers(const unsigned populationSize,
+        const long double mutationProbability, const unsigned numOfIslands);
+
+// Every (instance, solver, budget, seed) run is a separate task on a shared pool,
+// runs of multithreaded solvers follow one at a time once the pool is done
+std::vector<Point> run(const std::vector<Instance>& instances, const std::vector<Solver>& solvers,
+        const Settings& settings);
+
+// Interpolated mean wall time at which the mean gap drops to targetGap, infinity if never
+long double timeToTarget(const std::vector<Point>& points, const std::string& instance,
+        const std::string& solver, const long double targetGap);
+
+// Half-width of the 95% confidence interval of the mean of given samples
+long double confidence95(const std::vector<long double>& samples);
+
+void writeCsv(std::ostream& os, const std::vector<Point>& points);
+void writeTimeToTarget(std::ostream& os, const std::vector<Point>& points,
+        const long double targetGap);
+
+}
+
+#endif /* QUALITYHARNESS_HPP_ */
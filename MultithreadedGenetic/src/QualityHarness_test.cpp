@@ -0,0 +1,57 @@
+#include "QualityHarness.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+TEST(QualityHarness, readsInstancesWithKnownOptima)
+{
+    const auto instances = QualityHarness::readInstances("/home/dec/studia/sem6/zwsisk");
+    ASSERT_FALSE(instances.empty());
+    ASSERT_EQ("graph_full_matrix", instances[0].name_);
+    ASSERT_EQ(4, instances[0].optimum_);
+}
+
+TEST(QualityHarness, computesConfidenceInterval)
+{
+    ASSERT_DOUBLE_EQ(0.0, QualityHarness::confidence95({5.0}));
+    ASSERT_DOUBLE_EQ(0.0, QualityHarness::confidence95({5.0, 5.0, 5.0}));
+    // stddev = sqrt(2), n = 2, t(1) = 12.706
+    ASSERT_NEAR(12.706, QualityHarness::confidence95({1.0, 3.0}), 1e-9);
+}
+
+TEST(QualityHarness, interpolatesTimeToTarget)
+{
+    std::vector<QualityHarness::Point> points(2);
+    points[0].instance_ = points[1].instance_ = "i";
+    points[0].solver_ = points[1].solver_ = "s";
+    points[0].meanGap_ = 0.2;
+    points[0].meanMillis_ = 10;
+    points[1].meanGap_ = 0.0;
+    points[1].meanMillis_ = 30;
+    ASSERT_DOUBLE_EQ(20.0, QualityHarness::timeToTarget(points, "i", "s", 0.1));
+    ASSERT_DOUBLE_EQ(10.0, QualityHarness::timeToTarget(points, "i", "s", 0.3));
+    ASSERT_TRUE(std::isinf(QualityHarness::timeToTarget(points, "i", "s", -0.1)));
+}
+
+TEST(QualityHarness, bruteForceHasNoGapOnSmallInstance)
+{
+    auto instances = QualityHarness::readInstances("/home/dec/studia/sem6/zwsisk");
+    instances.resize(1);
+    QualityHarness::Settings settings;
+    settings.numOfSeeds_ = 2;
+    settings.budgets_ = {5};
+    const auto points = QualityHarness::run(instances,
+            QualityHarness::defaultSolvers(10, 0.01, 2), settings);
+    ASSERT_EQ(6, points.size());
+    for (const auto& p : points)
+    {
+        ASSERT_EQ(2, p.numOfSeeds_);
+        if (p.solver_ == "bruteForce")
+        {
+            ASSERT_DOUBLE_EQ(0.0, p.meanGap_);
+        }
+    }
+}
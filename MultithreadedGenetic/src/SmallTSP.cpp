@@ -0,0 +1,87 @@
+#include "SmallTSP.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace SmallInstances
+{
+
+namespace
+{
+
+using BruteForce = Solution (*)(const DistanceMatrix&);
+using Genetic = Solution (*)(const DistanceMatrix&, const GeneticParameters&, RandomGenerator&,
+        const Population&);
+
+template<unsigned N>
+Solution bruteForceOf(const DistanceMatrix& distances)
+{
+    return SmallTSP<N>(distances).bruteForce();
+}
+
+template<unsigned N>
+Solution geneticOf(const DistanceMatrix& distances, const GeneticParameters& parameters,
+        RandomGenerator& randomGen, const Population& population)
+{
+    return SmallTSP<N>(distances).genetic(parameters, randomGen, population);
+}
+
+// Entry i handles MIN_NUM_OF_CITIES + i cities
+template<unsigned... I>
+constexpr std::array<BruteForce, sizeof...(I)> bruteForceTable(std::integer_sequence<unsigned, I...>)
+{
+    return {{ &bruteForceOf<MIN_NUM_OF_CITIES + I>... }};
+}
+
+template<unsigned... I>
+constexpr std::array<Genetic, sizeof...(I)> geneticTable(std::integer_sequence<unsigned, I...>)
+{
+    return {{ &geneticOf<MIN_NUM_OF_CITIES + I>... }};
+}
+
+const auto bruteForces = bruteForceTable(std::make_integer_sequence<unsigned,
+        MAX_NUM_OF_CITIES_BRUTE_FORCE - MIN_NUM_OF_CITIES + 1>());
+const auto genetics = geneticTable(std::make_integer_sequence<unsigned,
+        MAX_NUM_OF_CITIES_GENETIC - MIN_NUM_OF_CITIES + 1>());
+
+void throwUnsupported(const unsigned numOfCities)
+{
+    throw std::runtime_error { " * No small instance solver for " + std::to_string(numOfCities)
+            + " cities * " };
+}
+
+}
+
+bool supportsBruteForce(const unsigned numOfCities)
+{
+    return numOfCities >= MIN_NUM_OF_CITIES && numOfCities <= MAX_NUM_OF_CITIES_BRUTE_FORCE;
+}
+
+bool supportsGenetic(const unsigned numOfCities)
+{
+    return numOfCities >= MIN_NUM_OF_CITIES && numOfCities <= MAX_NUM_OF_CITIES_GENETIC;
+}
+
+Solution bruteForce(const DistanceMatrix& distances)
+{
+    if (!supportsBruteForce(distances.getNumOfCities()))
+    {
+        throwUnsupported(distances.getNumOfCities());
+    }
+    return bruteForces[distances.getNumOfCities() - MIN_NUM_OF_CITIES](distances);
+}
+
+Solution genetic(const DistanceMatrix& distances, const GeneticParameters& parameters,
+        RandomGenerator& randomGen, const Population& population /*= Population(0)*/)
+{
+    if (!supportsGenetic(distances.getNumOfCities()))
+    {
+        throwUnsupported(distances.getNumOfCities());
+    }
+    return genetics[distances.getNumOfCities() - MIN_NUM_OF_CITIES](distances, parameters,
+            randomGen, population);
+}
+
+}
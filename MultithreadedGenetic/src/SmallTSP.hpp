@@ -0,0 +1,136 @@
+#ifndef SMALLTSP_HPP_
+#define SMALLTSP_HPP_
+
+#include "DistanceMatrix.hpp"
+#include "GeneticEngine.hpp"
+#include "GeneticPolicies.hpp"
+#include "TSP.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <numeric>
+#include <utility>
+
+/*
+ * Solvers for instances whose number of cities N is known at compile time.
+ * Routes are std::array<uint8_t, N> and weights live in a fixed size table inside the
+ * solver object, so solving touches the heap only for the population vector.
+ * Tour costs are unrolled over N at compile time.
+ */
+
+// Distance provider keeping its own copy of the weights
+template<unsigned N>
+class FixedDistance
+{
+public:
+    explicit FixedDistance(const DistanceMatrix& distances)
+    {
+        for (auto from = 0U; from < N; ++from)
+        {
+            for (auto to = 0U; to < N; ++to)
+            {
+                weights_[from * N + to] = distances(from, to);
+            }
+        }
+    }
+
+    template<typename R>
+    unsigned operator()(const R& route) const
+    {
+        return sum(route, std::make_index_sequence<N>());
+    }
+
+private:
+    template<typename R, std::size_t... I>
+    unsigned sum(const R& route, std::index_sequence<I...>) const
+    {
+        unsigned cost = 0U;
+        (void)std::initializer_list<int>{
+                (cost += weights_[route[I] * N + route[(I + 1) % N]], 0)... };
+        return cost;
+    }
+
+    std::array<unsigned, N * N> weights_;
+};
+
+template<unsigned N>
+class SmallTSP
+{
+    static_assert(N >= 3 && N <= 255, "Cities of a small instance must fit in uint8_t");
+
+public:
+    using City = std::uint8_t;
+    using SmallRoute = std::array<City, N>;
+    using Engine = GeneticEngine<GeneticPolicies::TruncationSelection,
+            GeneticPolicies::OrderCrossover, GeneticPolicies::SwapMutation,
+            GeneticPolicies::ReplaceWorstHalf, FixedDistance<N>, SmallRoute>;
+
+    explicit SmallTSP(const DistanceMatrix& distances)
+            : distance_ { distances }
+    {}
+
+    // Same result as TSP::bruteForce: the lexicographically first optimal route.
+    // It starts with city 0, so only the permutations of the other cities are visited.
+    Solution bruteForce() const
+    {
+        SmallRoute route;
+        std::iota(route.begin(), route.end(), 0);
+        SmallRoute best = route;
+        unsigned shortestDistance = distance_(route);
+        while (std::next_permutation(route.begin() + 1, route.end()))
+        {
+            const unsigned currentDistance = distance_(route);
+            if (currentDistance < shortestDistance)
+            {
+                shortestDistance = currentDistance;
+                best = route;
+            }
+        }
+        return {shortestDistance, toRoute(best)};
+    }
+
+    Solution genetic(const GeneticParameters& parameters, RandomGenerator& randomGen,
+            const Population& population) const
+    {
+        typename Engine::Routes routes;
+        for (const auto& r : population)
+        {
+            SmallRoute route;
+            std::copy(r.begin(), r.end(), route.begin());
+            routes.push_back(route);
+        }
+        Engine engine(distance_, N, parameters);
+        const auto best = engine.run(randomGen, std::move(routes));
+        return {best.cost_, toRoute(best.route_)};
+    }
+
+private:
+    static Route toRoute(const SmallRoute& route)
+    {
+        return Route(route.begin(), route.end());
+    }
+
+    FixedDistance<N> distance_;
+};
+
+// Runtime dispatch to SmallTSP<N> for the supported numbers of cities
+namespace SmallInstances
+{
+
+constexpr unsigned MIN_NUM_OF_CITIES = 3;
+constexpr unsigned MAX_NUM_OF_CITIES_BRUTE_FORCE = 12;
+constexpr unsigned MAX_NUM_OF_CITIES_GENETIC = 32;
+
+bool supportsBruteForce(const unsigned numOfCities);
+bool supportsGenetic(const unsigned numOfCities);
+
+Solution bruteForce(const DistanceMatrix& distances);
+Solution genetic(const DistanceMatrix& distances, const GeneticParameters& parameters,
+        RandomGenerator& randomGen, const Population& population = Population(0));
+
+}
+
+#endif /* SMALLTSP_HPP_ */
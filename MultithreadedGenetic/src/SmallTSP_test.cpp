@@ -0,0 +1,68 @@
+#include "SmallTSP.hpp"
+#include "TSP.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+TEST(SmallTSP, bruteForceMatchesFullEnumeration)
+{
+    const TSP tsp(8, 1, 100);
+    Route route(8);
+    std::iota(route.begin(), route.end(), 0);
+    unsigned shortest = std::numeric_limits<unsigned>::max();
+    Route best;
+    do
+    {
+        const unsigned cost = tsp.calcCostOfRoute(route);
+        if (cost < shortest)
+        {
+            shortest = cost;
+            best = route;
+        }
+    }
+    while (std::next_permutation(route.begin(), route.end()));
+
+    const Solution s { SmallInstances::bruteForce(tsp.getDistances()) };
+    ASSERT_EQ(shortest, s.cost_);
+    ASSERT_TRUE(best == s.route_);
+}
+
+TEST(SmallTSP, fixedDistanceMatchesMatrix)
+{
+    const TSP tsp(16, 1, 100);
+    RandomGenerator randomGen { 5 };
+    Population population { tsp.generateInitPopulation(10, randomGen) };
+    const FixedDistance<16> distance { tsp.getDistances() };
+    for (const auto& route : population)
+    {
+        ASSERT_EQ(tsp.calcCostOfRoute(route), distance(route));
+    }
+}
+
+TEST(SmallTSP, geneticFindsAValidRoute)
+{
+    for (const unsigned numOfCities : {3U, 17U, 32U})
+    {
+        const TSP tsp(numOfCities, 1, 100);
+        RandomGenerator randomGen { numOfCities };
+        Solution s { SmallInstances::genetic(tsp.getDistances(), { 20, 0.1, 20 }, randomGen) };
+        ASSERT_EQ(tsp.calcCostOfRoute(s.route_), s.cost_);
+        std::sort(s.route_.begin(), s.route_.end());
+        Route expected(numOfCities);
+        std::iota(expected.begin(), expected.end(), 0);
+        ASSERT_TRUE(expected == s.route_);
+    }
+}
+
+TEST(SmallTSP, throwsOnUnsupportedSize)
+{
+    const TSP tsp(33, 1, 100);
+    RandomGenerator randomGen { 1 };
+    ASSERT_FALSE(SmallInstances::supportsGenetic(33));
+    ASSERT_THROW(SmallInstances::genetic(tsp.getDistances(), {}, randomGen), std::runtime_error);
+    ASSERT_THROW(SmallInstances::bruteForce(tsp.getDistances()), std::runtime_error);
+}
@@ -0,0 +1,505 @@
+#include "SolverServer.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+
+// Removes a socket left behind by a server that is gone, anything else at the path stays
+// and false is returned with errno set
+bool removeStaleSocket(const sockaddr_un& address)
+{
+    struct stat status;
+    if (::lstat(address.sun_path, &status) < 0)
+    {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(status.st_mode))
+    {
+        errno = EADDRINUSE;
+        return false;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const bool refused = ::connect(fd, reinterpret_cast<const sockaddr*>(&address),
+            sizeof(address)) < 0 && errno == ECONNREFUSED;
+    ::close(fd);
+    if (!refused)
+    {
+        errno = EADDRINUSE;
+        return false;
+    }
+    return ::unlink(address.sun_path) == 0 || errno == ENOENT;
+}
+
+}
+
+struct SolverServer::Connection
+{
+    Connection(const int fd, const unsigned id)
+            : fd_ { fd }, id_ { id }
+    {}
+
+    ~Connection()
+    {
+        ::close(fd_);
+    }
+
+    // Answers of a closed connection are dropped
+    void send(const std::string& line)
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        const std::string message { line + "\n" };
+        std::size_t sent = 0U;
+        while (sent < message.size())
+        {
+            const auto n = ::send(fd_, message.data() + sent, message.size() - sent,
+                    MSG_NOSIGNAL);
+            if (n <= 0)
+            {
+                return;
+            }
+            sent += n;
+        }
+    }
+
+    const int fd_;
+    const unsigned id_;
+    std::mutex m_;
+};
+
+namespace
+{
+
+template<typename Engine>
+Solution solveUntil(Engine& engine, RandomGenerator& randomGen, const unsigned maxNumOfGenerations,
+        const SolverServer::Clock::time_point deadline, const std::atomic<bool>& cancelled)
+{
+    auto population = engine.createPopulation({}, randomGen);
+    for (auto i = 0U; i < maxNumOfGenerations && SolverServer::Clock::now() < deadline
+            && !cancelled.load(std::memory_order_relaxed); ++i)
+    {
+        engine.step(population, randomGen);
+    }
+    const auto best = Engine::fittest(population);
+    return {best.cost_, Route(best.route_.begin(), best.route_.end())};
+}
+
+Solution solve(const TSP& tsp, const GeneticParameters& parameters, const std::uint64_t seed,
+        const SolverServer::Clock::time_point deadline, const std::atomic<bool>& cancelled)
+{
+    RandomGenerator randomGen { seed };
+    const GeneticPolicies::MatrixDistance distance { tsp.getDistances() };
+    if (fitsCityType<std::uint16_t>(tsp.getNumOfCities()))
+    {
+        DefaultGeneticEngineOf<std::uint16_t> engine(distance, tsp.getNumOfCities(), parameters);
+        return solveUntil(engine, randomGen, parameters.numOfGenerations_, deadline, cancelled);
+    }
+    DefaultGeneticEngine engine(distance, tsp.getNumOfCities(), parameters);
+    return solveUntil(engine, randomGen, parameters.numOfGenerations_, deadline, cancelled);
+}
+
+std::string toString(const Solution& solution)
+{
+    std::ostringstream ss;
+    ss << solution.cost_;
+    for (const auto city : solution.route_)
+    {
+        ss << ' ' << city;
+    }
+    return ss.str();
+}
+
+unsigned bucketOf(const unsigned numOfCities)
+{
+    unsigned bucket = 10U;
+    while (bucket < numOfCities && bucket < 1000000000U)
+    {
+        bucket *= 10U;
+    }
+    return bucket;
+}
+
+long double percentile(std::vector<long double> samples, const long double p)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<std::size_t>(p * (samples.size() - 1) + 0.5)];
+}
+
+}
+
+SolverServer::SolverServer(const Settings& settings)
+        : settings_ { settings }
+{}
+
+SolverServer::~SolverServer()
+{
+    stop();
+}
+
+void SolverServer::start()
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (settings_.socketPath_.empty() || settings_.socketPath_.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error { " * Invalid socket path: " + settings_.socketPath_ + " * " };
+    }
+    std::strcpy(address.sun_path, settings_.socketPath_.c_str());
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0 || !removeStaleSocket(address)
+            || ::bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0
+            || ::listen(listenFd_, SOMAXCONN) < 0)
+    {
+        const std::string error { std::strerror(errno) };
+        if (listenFd_ >= 0)
+        {
+            ::close(listenFd_);
+            listenFd_ = -1;
+        }
+        throw std::runtime_error { " * Couldn't listen on " + settings_.socketPath_ + ": "
+                + error + " * " };
+    }
+
+    started_ = true;
+    for (auto i = 0U; i < std::max(settings_.numOfWorkers_, 1U); ++i)
+    {
+        workers_.emplace_back([this](){work();});
+    }
+    acceptor_ = std::thread([this](){accept();});
+}
+
+void SolverServer::stop()
+{
+    if (!started_)
+    {
+        return;
+    }
+    started_ = false;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stopping_ = true;
+        for (auto& cancellation : cancellations_)
+        {
+            cancellation.second->store(true);
+        }
+        // Wakes up the readers blocked in recv
+        for (auto& connection : connections_)
+        {
+            ::shutdown(connection.second->fd_, SHUT_RDWR);
+        }
+    }
+    cv_.notify_all();
+    ::shutdown(listenFd_, SHUT_RDWR);
+    acceptor_.join();
+    ::close(listenFd_);
+    ::unlink(settings_.socketPath_.c_str());
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+
+    std::unique_lock<std::mutex> lock(m_);
+    cv_.wait(lock, [this](){return numOfReaders_ == 0;});
+    queues_.clear();
+    connections_.clear();
+}
+
+std::vector<SolverServer::BucketStats> SolverServer::getLatencies() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    std::vector<BucketStats> stats;
+    for (const auto& bucket : latencies_)
+    {
+        BucketStats s;
+        s.maxNumOfCities_ = bucket.first;
+        s.count_ = bucket.second.count_;
+        s.p50_ = percentile(bucket.second.millis_, 0.50);
+        s.p99_ = percentile(bucket.second.millis_, 0.99);
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+void SolverServer::accept()
+{
+    while (true)
+    {
+        const int fd = ::accept(listenFd_, nullptr, nullptr);
+        const int error = errno;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            if (stopping_)
+            {
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                }
+                return;
+            }
+            if (fd >= 0)
+            {
+                auto connection = std::make_shared<Connection>(fd, nextConnectionId_++);
+                connections_[connection->id_] = connection;
+                ++numOfReaders_;
+                std::thread([this, connection](){read(connection);}).detach();
+                continue;
+            }
+        }
+        // E.g. out of descriptors, retrying at once would only spin until some are closed
+        if (error != EINTR && error != ECONNABORTED)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+}
+
+void SolverServer::read(std::shared_ptr<Connection> connection)
+{
+    std::string buffer;
+    char chunk[4096];
+    ssize_t n = 0;
+    while ((n = ::recv(connection->fd_, chunk, sizeof(chunk), 0)) > 0)
+    {
+        buffer.append(chunk, n);
+        std::size_t end = 0U;
+        while ((end = buffer.find('\n')) != std::string::npos)
+        {
+            handle(connection, buffer.substr(0, end));
+            buffer.erase(0, end + 1);
+        }
+    }
+
+    // Nobody is waiting for the answers anymore
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        for (auto& cancellation : cancellations_)
+        {
+            if (cancellation.first.first == connection->id_)
+            {
+                cancellation.second->store(true);
+            }
+        }
+        connections_.erase(connection->id_);
+        --numOfReaders_;
+        cv_.notify_all();
+    }
+}
+
+void SolverServer::handle(const std::shared_ptr<Connection>& connection, const std::string& line)
+{
+    std::istringstream ss(line);
+    std::string command;
+    ss >> command;
+    if (command == "LOAD")
+    {
+        std::string instance;
+        std::string path;
+        if (!(ss >> instance >> path))
+        {
+            connection->send("ERROR * Usage: LOAD <instance> <path> *");
+            return;
+        }
+        try
+        {
+            auto tsp = std::make_shared<const TSP>(path);
+            const unsigned numOfCities = tsp->getNumOfCities();
+            {
+                std::lock_guard<std::mutex> lock(m_);
+                instances_[instance] = std::move(tsp);
+            }
+            connection->send("OK " + instance + " " + std::to_string(numOfCities));
+        }
+        catch (const std::exception& e)
+        {
+            connection->send(std::string("ERROR ") + e.what());
+        }
+    }
+    else if (command == "SOLVE")
+    {
+        Request request;
+        std::string instance;
+        if (!(ss >> request.id_ >> instance >> request.millis_ >> request.seed_))
+        {
+            connection->send("ERROR * Usage: SOLVE <request> <instance> <millis> <seed> *");
+            return;
+        }
+        request.connection_ = connection;
+        request.cancelled_ = std::make_shared<std::atomic<bool>>(false);
+        request.received_ = Clock::now();
+        // Answers are sent after m_ is released, a client that doesn't read blocks only itself
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            const auto it = instances_.find(instance);
+            const auto key = std::make_pair(connection->id_, request.id_);
+            if (it == instances_.end() || cancellations_.count(key))
+            {
+                error = "ERROR * " + (it == instances_.end() ? "Unknown instance " + instance
+                        : "Request " + request.id_ + " is already pending") + " *";
+            }
+            else
+            {
+                request.tsp_ = it->second;
+                cancellations_[key] = request.cancelled_;
+                queues_[connection->id_].push_back(std::move(request));
+            }
+        }
+        if (!error.empty())
+        {
+            connection->send(error);
+            return;
+        }
+        cv_.notify_one();
+    }
+    else if (command == "CANCEL")
+    {
+        std::string id;
+        ss >> id;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            const auto it = cancellations_.find(std::make_pair(connection->id_, id));
+            if (it != cancellations_.end())
+            {
+                it->second->store(true);
+                found = true;
+            }
+        }
+        connection->send(found ? "OK " + id : "ERROR * Unknown request " + id + " *");
+    }
+    else if (command == "STATS")
+    {
+        for (const auto& bucket : getLatencies())
+        {
+            std::ostringstream stats;
+            stats << "STATS " << bucket.maxNumOfCities_ << ' ' << bucket.count_ << ' '
+                    << bucket.p50_ << ' ' << bucket.p99_;
+            connection->send(stats.str());
+        }
+        connection->send("END");
+    }
+    else if (!command.empty())
+    {
+        connection->send("ERROR * Unknown command " + command + " *");
+    }
+}
+
+void SolverServer::work()
+{
+    while (true)
+    {
+        std::vector<Request> batch;
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            ++numOfIdleWorkers_;
+            cv_.wait(lock, [this](){return stopping_ || !queues_.empty();});
+            --numOfIdleWorkers_;
+            if (stopping_)
+            {
+                return;
+            }
+            batch = takeBatch();
+        }
+        for (const auto& request : batch)
+        {
+            serve(request);
+        }
+    }
+}
+
+std::vector<SolverServer::Request> SolverServer::takeBatch()
+{
+    auto next = queues_.upper_bound(lastServed_);
+    if (next == queues_.end())
+    {
+        next = queues_.begin();
+    }
+    lastServed_ = next->first;
+    std::vector<Request> batch;
+    batch.push_back(std::move(next->second.front()));
+    next->second.pop_front();
+
+    // Requests idle workers will take are left to them, they don't wait behind this batch
+    std::size_t numOfQueued = 0U;
+    for (const auto& queue : queues_)
+    {
+        numOfQueued += queue.second.size();
+    }
+    const std::size_t maxBatchSize = std::min<std::size_t>(settings_.maxBatchSize_,
+            1 + (numOfQueued > numOfIdleWorkers_ ? numOfQueued - numOfIdleWorkers_ : 0U));
+
+    // Only heads of the queues, so every connection's requests keep their order
+    bool found = true;
+    while (found && batch.size() < maxBatchSize)
+    {
+        found = false;
+        for (auto& queue : queues_)
+        {
+            if (!queue.second.empty() && queue.second.front().tsp_ == batch.front().tsp_
+                    && batch.size() < maxBatchSize)
+            {
+                batch.push_back(std::move(queue.second.front()));
+                queue.second.pop_front();
+                found = true;
+            }
+        }
+    }
+    for (auto it = queues_.begin(); it != queues_.end();)
+    {
+        it = it->second.empty() ? queues_.erase(it) : std::next(it);
+    }
+    return batch;
+}
+
+void SolverServer::serve(const Request& request)
+{
+    std::string answer { "CANCELLED " + request.id_ };
+    if (!request.cancelled_->load())
+    {
+        // A request that waited past its limit gets no generations and is answered at once
+        const auto deadline = request.received_ + std::chrono::milliseconds(request.millis_);
+        const Solution solution { solve(*request.tsp_, settings_.parameters_, request.seed_,
+                deadline, *request.cancelled_) };
+        answer = (request.cancelled_->load() ? "CANCELLED " : "RESULT ") + request.id_ + " "
+                + toString(solution);
+    }
+    {
+        // Before answering, so the client may reuse the id right away
+        std::lock_guard<std::mutex> lock(m_);
+        cancellations_.erase(std::make_pair(request.connection_->id_, request.id_));
+    }
+    // Recorded first, so STATS sent after the answer arrived already counts it
+    record(request.tsp_->getNumOfCities(), std::chrono::duration<long double, std::milli>(
+            Clock::now() - request.received_).count());
+    request.connection_->send(answer);
+}
+
+void SolverServer::record(const unsigned numOfCities, const long double millis)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    Samples& samples = latencies_[bucketOf(numOfCities)];
+    if (samples.millis_.size() < NUM_OF_SAMPLES)
+    {
+        samples.millis_.push_back(millis);
+    }
+    else
+    {
+        samples.millis_[samples.count_ % NUM_OF_SAMPLES] = millis;
+    }
+    ++samples.count_;
+}
@@ -0,0 +1,125 @@
+#ifndef SOLVERSERVER_HPP_
+#define SOLVERSERVER_HPP_
+
+#include "GeneticEngine.hpp"
+#include "TSP.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Long-running solver keeping loaded instances and worker threads resident. Clients talk
+ * to it over a Unix domain socket, one request per line:
+ *   LOAD <instance> <path>                    -> OK <instance> <numOfCities>
+ *   SOLVE <request> <instance> <millis> <seed> -> RESULT <request> <cost> <city>...
+ *   CANCEL <request>                          -> OK <request>, the SOLVE answers
+ *                                                CANCELLED <request> [<cost> <city>...]
+ *   STATS                                     -> STATS <maxNumOfCities> <count> <p50> <p99>
+ *                                                per size bucket, then END
+ * Failures are answered with ERROR <message>. Request ids are scoped to a connection,
+ * answers to SOLVE come in the order of completion.
+ *
+ * Queued requests are served round-robin between connections, so no client can starve
+ * the others. A worker taking a request also takes queued requests for the same instance
+ * that no idle worker is left for, up to maxBatchSize_, and solves them one after another
+ * while the instance's weights are still in its cache. The time limit of a SOLVE counts
+ * from receiving it, a request that waited past it is answered with what one evaluated
+ * population gives. Latency is measured from receiving a SOLVE to answering it.
+ */
+class SolverServer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings
+    {
+        std::string socketPath_;
+        unsigned numOfWorkers_ = std::thread::hardware_concurrency();
+        unsigned maxBatchSize_ = 8;
+        // numOfGenerations_ caps a solve that still has time left
+        GeneticParameters parameters_ { 150, 0.01, 1000000 };
+    };
+
+    struct BucketStats
+    {
+        unsigned maxNumOfCities_ = 0U;
+        unsigned long long count_ = 0U;
+        long double p50_ = 0.0;
+        long double p99_ = 0.0;
+    };
+
+    explicit SolverServer(const Settings& settings);
+    SolverServer(const SolverServer&) = delete;
+    SolverServer& operator=(const SolverServer&) = delete;
+    ~SolverServer();
+
+    // Binds the socket and starts serving, throws std::runtime_error if the socket fails
+    void start();
+    // Cancels running requests and waits for every thread
+    void stop();
+
+    // Latency in milliseconds of the last NUM_OF_SAMPLES answers per bucket
+    std::vector<BucketStats> getLatencies() const;
+
+    static constexpr unsigned NUM_OF_SAMPLES = 4096;
+
+private:
+    struct Connection;
+    struct Request
+    {
+        std::shared_ptr<Connection> connection_;
+        std::string id_;
+        std::shared_ptr<const TSP> tsp_;
+        unsigned millis_ = 0U;
+        std::uint64_t seed_ = 0U;
+        std::shared_ptr<std::atomic<bool>> cancelled_;
+        Clock::time_point received_;
+    };
+    struct Samples
+    {
+        unsigned long long count_ = 0U;
+        std::vector<long double> millis_;
+    };
+
+    void accept();
+    void read(std::shared_ptr<Connection> connection);
+    void handle(const std::shared_ptr<Connection>& connection, const std::string& line);
+    void work();
+    std::vector<Request> takeBatch();
+    void serve(const Request& request);
+    void record(const unsigned numOfCities, const long double millis);
+
+    const Settings settings_;
+    int listenFd_ = -1;
+    bool started_ = false;
+    std::thread acceptor_;
+    std::vector<std::thread> workers_;
+
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    unsigned nextConnectionId_ = 0U;
+    unsigned numOfReaders_ = 0U;
+    // Workers waiting for requests, batches leave them the queued requests
+    unsigned numOfIdleWorkers_ = 0U;
+    std::map<unsigned, std::shared_ptr<Connection>> connections_;
+    std::map<std::string, std::shared_ptr<const TSP>> instances_;
+    // Queued requests of every connection, served round-robin after lastServed_
+    std::map<unsigned, std::deque<Request>> queues_;
+    unsigned lastServed_ = 0U;
+    std::map<std::pair<unsigned, std::string>, std::shared_ptr<std::atomic<bool>>> cancellations_;
+    // Buckets of 10, 100, ... cities
+    std::map<unsigned, Samples> latencies_;
+};
+
+#endif /* SOLVERSERVER_HPP_ */
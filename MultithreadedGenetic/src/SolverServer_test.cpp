@@ -0,0 +1,193 @@
+#include "SolverServer.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using testing::HasSubstr;
+using testing::StartsWith;
+
+namespace
+{
+
+class Client
+{
+public:
+    explicit Client(const std::string& socketPath)
+            : fd_ { ::socket(AF_UNIX, SOCK_STREAM, 0) }
+    {
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, socketPath.c_str());
+        connected_ = ::connect(fd_, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) == 0;
+    }
+
+    ~Client()
+    {
+        ::close(fd_);
+    }
+
+    bool isConnected() const
+    {
+        return connected_;
+    }
+
+    void send(const std::string& line)
+    {
+        const std::string message { line + "\n" };
+        ::send(fd_, message.data(), message.size(), MSG_NOSIGNAL);
+    }
+
+    std::string receive()
+    {
+        std::size_t end = 0U;
+        char chunk[4096];
+        while ((end = buffer_.find('\n')) == std::string::npos)
+        {
+            const auto n = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+            {
+                return "";
+            }
+            buffer_.append(chunk, n);
+        }
+        const std::string line { buffer_.substr(0, end) };
+        buffer_.erase(0, end + 1);
+        return line;
+    }
+
+private:
+    const int fd_;
+    bool connected_ = false;
+    std::string buffer_;
+};
+
+std::vector<unsigned> citiesOf(const std::string& answer)
+{
+    std::istringstream ss(answer);
+    std::string word;
+    unsigned cost = 0U;
+    ss >> word >> word >> cost;
+    std::vector<unsigned> cities;
+    unsigned city = 0U;
+    while (ss >> city)
+    {
+        cities.push_back(city);
+    }
+    return cities;
+}
+
+}
+
+class SolverServerFixture : public ::testing::Test
+{
+protected:
+    SolverServerFixture()
+    {
+        settings_.socketPath_ = "/tmp/zwsisk_test_" + std::to_string(::getpid()) + ".sock";
+        settings_.numOfWorkers_ = 2;
+        server_.reset(new SolverServer(settings_));
+        server_->start();
+    }
+
+    SolverServer::Settings settings_;
+    std::unique_ptr<SolverServer> server_;
+};
+
+TEST_F(SolverServerFixture, solvesLoadedInstance)
+{
+    Client client(settings_.socketPath_);
+    ASSERT_TRUE(client.isConnected());
+    client.send("LOAD swiss /home/dec/studia/sem6/zwsisk/swiss42.tsp");
+    ASSERT_EQ("OK swiss 42", client.receive());
+    client.send("SOLVE r1 swiss 20 1");
+    const std::string answer { client.receive() };
+    ASSERT_THAT(answer, StartsWith("RESULT r1 "));
+    const auto cities = citiesOf(answer);
+    ASSERT_EQ(42U, cities.size());
+    ASSERT_EQ(42U, std::set<unsigned>(cities.begin(), cities.end()).size());
+
+    client.send("STATS");
+    ASSERT_EQ("STATS 100 1", client.receive().substr(0, 11));
+    ASSERT_EQ("END", client.receive());
+    ASSERT_EQ(1U, server_->getLatencies().size());
+}
+
+TEST_F(SolverServerFixture, refusesPathInUse)
+{
+    SolverServer second(settings_);
+    ASSERT_THROW(second.start(), std::runtime_error);
+    Client client(settings_.socketPath_);
+    ASSERT_TRUE(client.isConnected());
+
+    SolverServer::Settings settings;
+    settings.socketPath_ = settings_.socketPath_ + ".txt";
+    std::ofstream(settings.socketPath_) << "not a socket";
+    SolverServer onFile(settings);
+    ASSERT_THROW(onFile.start(), std::runtime_error);
+    ASSERT_EQ(0, ::unlink(settings.socketPath_.c_str()));
+}
+
+TEST_F(SolverServerFixture, answersErrors)
+{
+    Client client(settings_.socketPath_);
+    client.send("SOLVE r1 unknown 10 1");
+    ASSERT_THAT(client.receive(), StartsWith("ERROR"));
+    client.send("LOAD x /nonexistent.tsp");
+    ASSERT_THAT(client.receive(), StartsWith("ERROR"));
+    client.send("CANCEL nothing");
+    ASSERT_THAT(client.receive(), StartsWith("ERROR"));
+    client.send("WITAM");
+    ASSERT_THAT(client.receive(), StartsWith("ERROR"));
+}
+
+TEST_F(SolverServerFixture, cancelsRunningRequest)
+{
+    Client client(settings_.socketPath_);
+    client.send("LOAD swiss /home/dec/studia/sem6/zwsisk/swiss42.tsp");
+    client.receive();
+    client.send("SOLVE long swiss 60000 1");
+    ::usleep(20000);
+    client.send("CANCEL long");
+    const std::set<std::string> answers { client.receive().substr(0, 14),
+            client.receive().substr(0, 14) };
+    ASSERT_TRUE(answers.count("OK long"));
+    ASSERT_TRUE(answers.count("CANCELLED long"));
+}
+
+TEST_F(SolverServerFixture, servesManyClients)
+{
+    Client first(settings_.socketPath_);
+    Client second(settings_.socketPath_);
+    first.send("LOAD g /home/dec/studia/sem6/zwsisk/graph_full_matrix.txt");
+    ASSERT_EQ("OK g 4", first.receive());
+    for (auto i = 0; i < 5; ++i)
+    {
+        first.send("SOLVE a" + std::to_string(i) + " g 1 " + std::to_string(i));
+        second.send("SOLVE b" + std::to_string(i) + " g 1 " + std::to_string(i));
+    }
+    // Workers answer in any order
+    std::set<std::string> answers;
+    for (auto i = 0; i < 5; ++i)
+    {
+        answers.insert(first.receive().substr(0, 11));
+        answers.insert(second.receive().substr(0, 11));
+    }
+    for (auto i = 0; i < 5; ++i)
+    {
+        ASSERT_TRUE(answers.count("RESULT a" + std::to_string(i) + " 4"));
+        ASSERT_TRUE(answers.count("RESULT b" + std::to_string(i) + " 4"));
+    }
+}
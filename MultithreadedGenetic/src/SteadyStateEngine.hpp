@@ -0,0 +1,200 @@
+#ifndef STEADYSTATEENGINE_HPP_
+#define STEADYSTATEENGINE_HPP_
+
+#include "GeneticEngine.hpp"
+#include "GeneticPolicies.hpp"
+#include "TSP.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Steady-state genetic algorithm without generations: worker threads share one population,
+ * each of them repeatedly breeds a child from two tournament winners and puts it in place
+ * of the most expensive individual if the child is cheaper. Every slot of the population
+ * has its own lock and an atomic copy of its cost, so tournaments and the search for the
+ * worst individual read costs without locking, and a worker waits only for the slots it
+ * actually touches. Results of runs with more than one thread are not reproducible.
+ */
+template<typename Crossover, typename Mutation, typename Distance, typename R = Route>
+class SteadyStateEngine
+{
+public:
+    using Result = BasicSolution<R>;
+    using Routes = std::vector<R>;
+
+    static constexpr unsigned TOURNAMENT_SIZE = 3;
+    // Replacement gives up after that many lost races for the worst slot
+    static constexpr unsigned NUM_OF_REPLACEMENT_ATTEMPTS = 3;
+
+    SteadyStateEngine(Distance distance, const unsigned numOfCities,
+            const GeneticParameters& parameters, const unsigned numOfThreads)
+            : distance_ { std::move(distance) }, numOfCities_ { numOfCities },
+              parameters_ { parameters }, numOfThreads_ { std::max(numOfThreads, 1U) }
+    {}
+
+    // Breeds as many children as numOfGenerations generations of the generational engine
+    Result run(RandomGenerator& randomGen, Routes routes = Routes(0))
+    {
+        if (routes.empty())
+        {
+            R route { GeneticPolicies::RouteTraits<R>::identity(numOfCities_) };
+            for (auto i = 0U; i < parameters_.populationSize_; ++i)
+            {
+                std::shuffle(route.begin(), route.end(), randomGen);
+                routes.push_back(route);
+            }
+        }
+
+        size_ = routes.size();
+        slots_.reset(new Slot[size_]);
+        costs_.reset(new std::atomic<unsigned>[size_]);
+        for (auto i = 0U; i < size_; ++i)
+        {
+            costs_[i].store(distance_(routes[i]), std::memory_order_relaxed);
+            slots_[i].route_ = std::move(routes[i]);
+        }
+        numOfOffspring_.store(0U);
+        numOfReplacements_.store(0U);
+        budget_ = static_cast<unsigned long long>(parameters_.numOfGenerations_)
+                * (size_ - size_ / 2);
+
+        std::vector<std::thread> workers;
+        for (auto i = 0U; i < numOfThreads_; ++i)
+        {
+            workers.emplace_back(&SteadyStateEngine::work, this, randomGen());
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        unsigned best = 0U;
+        for (auto i = 1U; i < size_; ++i)
+        {
+            if (costs_[i].load(std::memory_order_relaxed)
+                    < costs_[best].load(std::memory_order_relaxed))
+            {
+                best = i;
+            }
+        }
+        return {costs_[best].load(), std::move(slots_[best].route_)};
+    }
+
+    // Children bred by the last run that made it into the population
+    unsigned long long getNumOfReplacements() const
+    {
+        return numOfReplacements_.load();
+    }
+
+private:
+    struct Slot
+    {
+        std::mutex m_;
+        R route_;
+    };
+
+    void work(const std::uint64_t seed)
+    {
+        RandomGenerator randomGen { seed };
+        std::uniform_real_distribution<long double> distr(0, 1);
+        Crossover crossover;
+        Mutation mutation;
+        R child { GeneticPolicies::RouteTraits<R>::identity(numOfCities_) };
+
+        while (numOfOffspring_.fetch_add(1U, std::memory_order_relaxed) < budget_)
+        {
+            const unsigned parent_a = pick(randomGen);
+            unsigned parent_b = pick(randomGen);
+            for (auto i = 0U; size_ > 1 && parent_a == parent_b && i < TOURNAMENT_SIZE; ++i)
+            {
+                parent_b = pick(randomGen);
+            }
+            {
+                std::unique_lock<std::mutex> lock_a(slots_[parent_a].m_, std::defer_lock);
+                std::unique_lock<std::mutex> lock_b(slots_[parent_b].m_, std::defer_lock);
+                if (parent_a == parent_b)
+                {
+                    lock_a.lock();
+                }
+                else
+                {
+                    std::lock(lock_a, lock_b);
+                }
+                crossover(slots_[parent_a].route_, slots_[parent_b].route_, child, randomGen);
+            }
+            if (distr(randomGen) <= parameters_.mutationProbability_)
+            {
+                mutation(child, randomGen);
+            }
+            replaceWorst(child, distance_(child));
+        }
+    }
+
+    unsigned pick(RandomGenerator& randomGen) const
+    {
+        std::uniform_int_distribution<unsigned> distr(0, size_ - 1);
+        unsigned best = distr(randomGen);
+        for (auto i = 1U; i < TOURNAMENT_SIZE; ++i)
+        {
+            const unsigned contestant = distr(randomGen);
+            if (costs_[contestant].load(std::memory_order_relaxed)
+                    < costs_[best].load(std::memory_order_relaxed))
+            {
+                best = contestant;
+            }
+        }
+        return best;
+    }
+
+    // The child's buffer gets the displaced route, so it is reused for the next child
+    void replaceWorst(R& child, const unsigned cost)
+    {
+        for (auto attempt = 0U; attempt < NUM_OF_REPLACEMENT_ATTEMPTS; ++attempt)
+        {
+            unsigned worst = 0U;
+            for (auto i = 1U; i < size_; ++i)
+            {
+                if (costs_[i].load(std::memory_order_relaxed)
+                        > costs_[worst].load(std::memory_order_relaxed))
+                {
+                    worst = i;
+                }
+            }
+            if (costs_[worst].load(std::memory_order_relaxed) <= cost)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(slots_[worst].m_);
+            // Another worker may have replaced it after the scan
+            if (costs_[worst].load(std::memory_order_relaxed) > cost)
+            {
+                std::swap(slots_[worst].route_, child);
+                costs_[worst].store(cost, std::memory_order_relaxed);
+                numOfReplacements_.fetch_add(1U, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    const Distance distance_;
+    const unsigned numOfCities_;
+    const GeneticParameters parameters_;
+    const unsigned numOfThreads_;
+    unsigned size_ = 0U;
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<std::atomic<unsigned>[]> costs_;
+    unsigned long long budget_ = 0U;
+    std::atomic<unsigned long long> numOfOffspring_ { 0U };
+    std::atomic<unsigned long long> numOfReplacements_ { 0U };
+};
+
+#endif /* STEADYSTATEENGINE_HPP_ */
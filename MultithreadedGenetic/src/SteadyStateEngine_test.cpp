@@ -0,0 +1,59 @@
+#include "SteadyStateEngine.hpp"
+#include "TSP.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+
+using Engine = SteadyStateEngine<GeneticPolicies::OrderCrossover,
+        GeneticPolicies::InversionMutation, GeneticPolicies::MatrixDistance>;
+
+}
+
+class SteadyStateEngineFixture : public ::testing::Test
+{
+protected:
+    const TSP tsp_{"/home/dec/studia/sem6/zwsisk/swiss42.tsp"};
+    RandomGenerator randomGen_{5};
+};
+
+TEST_F(SteadyStateEngineFixture, findsAValidRouteWithManyThreads)
+{
+    Engine engine(GeneticPolicies::MatrixDistance { tsp_.getDistances() },
+            tsp_.getNumOfCities(), { 30, 0.3, 100 }, 4);
+    Solution s { engine.run(randomGen_) };
+    ASSERT_EQ(tsp_.calcCostOfRoute(s.route_), s.cost_);
+    Route expected(tsp_.getNumOfCities());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(s.route_.begin(), s.route_.end());
+    ASSERT_EQ(expected, s.route_);
+    ASSERT_GT(engine.getNumOfReplacements(), 0U);
+}
+
+TEST_F(SteadyStateEngineFixture, neverLosesTheBestRoute)
+{
+    const Population population { tsp_.generateInitPopulation(30, randomGen_) };
+    unsigned bestInitial = tsp_.calcCostOfRoute(population[0]);
+    for (const auto& route : population)
+    {
+        bestInitial = std::min(bestInitial, tsp_.calcCostOfRoute(route));
+    }
+    Engine engine(GeneticPolicies::MatrixDistance { tsp_.getDistances() },
+            tsp_.getNumOfCities(), { 30, 0.3, 50 }, 3);
+    ASSERT_LE(engine.run(randomGen_, population).cost_, bestInitial);
+}
+
+TEST_F(SteadyStateEngineFixture, isReproducibleWithOneThread)
+{
+    RandomGenerator first { 9 };
+    RandomGenerator second { 9 };
+    const Solution a { tsp_.genetic_steady(20, 0.2, 50, 1, first) };
+    const Solution b { tsp_.genetic_steady(20, 0.2, 50, 1, second) };
+    ASSERT_EQ(a.cost_, b.cost_);
+    ASSERT_EQ(a.route_, b.route_);
+}
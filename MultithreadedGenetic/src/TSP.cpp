@@ -1,26 +1,77 @@
 #include "TSP.hpp"
+#include "AdaptiveEngine.hpp"
+#include "GeneticEngine.hpp"
+#include "SmallTSP.hpp"
+#include "SteadyStateEngine.hpp"
 
 #include <algorithm>
 #include <climits>
 #include <future>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
 #include <random>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
+namespace
+{
+
+// Matrix instances are checked in place, a graph copy would double their memory
+DistanceMatrix validated(DistanceMatrix distances)
+{
+    const unsigned n = distances.getNumOfCities();
+    for (auto from = 0U; from < n; ++from)
+    {
+        for (auto to = from + 1; to < n; ++to)
+        {
+            if (distances(from, to) == 0 || distances(from, to) != distances(to, from))
+            {
+                throw std::runtime_error { " * Weights need to be positive and symmetric * " };
+            }
+        }
+    }
+    return distances;
+}
+
+// Of every undirected edge, missing edges weigh 0
+unsigned long long sumOf(const DistanceMatrix& distances)
+{
+    unsigned long long sum = 0U;
+    for (auto from = 0U; from < distances.getNumOfCities(); ++from)
+    {
+        for (auto to = from + 1; to < distances.getNumOfCities(); ++to)
+        {
+            sum += distances(from, to);
+        }
+    }
+    return sum;
+}
+
+}
+
 TSP::TSP(const unsigned numOfCities)
-        : graph_(numOfCities), numOfCities_(numOfCities), sumOfCosts_(graph_.getSumOfWeights())
+        : distances_(Graph(numOfCities)), numOfCities_(numOfCities),
+          sumOfCosts_(sumOf(distances_))
 {}
 
 TSP::TSP(const unsigned numOfCities, const unsigned minCost, const unsigned maxCost)
-        : graph_ { numOfCities, minCost, maxCost }, numOfCities_(numOfCities),
-          sumOfCosts_(graph_.getSumOfWeights())
+        : distances_(Graph(numOfCities, minCost, maxCost)), numOfCities_(numOfCities),
+          sumOfCosts_(sumOf(distances_))
 {}
 
 TSP::TSP(std::string pathToFile)
-        : graph_(pathToFile), numOfCities_(graph_.getNumberOfVertices()),
-          sumOfCosts_(graph_.getSumOfWeights())
+        : distances_(Graph(pathToFile)), numOfCities_(distances_.getNumOfCities()),
+          sumOfCosts_(sumOf(distances_))
 {}
 
-unsigned TSP::getSumOfCosts() const
+TSP::TSP(DistanceMatrix distances)
+        : distances_ { validated(std::move(distances)) },
+          numOfCities_ { distances_.getNumOfCities() }, sumOfCosts_ { sumOf(distances_) }
+{}
+
+unsigned long long TSP::getSumOfCosts() const
 {
     return sumOfCosts_;
 }
@@ -32,11 +83,53 @@ unsigned TSP::getNumOfCities() const
 
 unsigned TSP::getCostBetweenCities(const unsigned from, const unsigned to) const
 {
-    return graph_.getWeightOfEdge(from, to);
+    if (!edgeExists(from, to))
+    {
+        throw std::runtime_error { "Edge from " + std::to_string(from) + " to "
+                + std::to_string(to) + " does not exist." };
+    }
+    return distances_(from, to);
+}
+
+bool TSP::edgeExists(const unsigned from, const unsigned to) const
+{
+    return from < numOfCities_ && to < numOfCities_ && distances_(from, to) != 0U;
+}
+
+void TSP::seed(const std::uint64_t seed)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    randomGen_.seed(seed);
+}
+
+std::uint64_t TSP::nextSeed() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return randomGen_();
+}
+
+const DistanceMatrix& TSP::getReplica(const unsigned node) const
+{
+    Replica* replica = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        replica = &replicas_[node];
+    }
+    // Copied outside m_, islands of other nodes don't wait for this node's copy
+    std::call_once(replica->copied_, [this, replica]()
+            {
+                replica->distances_ = std::make_unique<const DistanceMatrix>(distances_);
+            });
+    return *replica->distances_;
 }
 
 Solution TSP::bruteForce() const
 {
+    if (SmallInstances::supportsBruteForce(numOfCities_))
+    {
+        return SmallInstances::bruteForce(distances_);
+    }
+
     unsigned shortestDistance = std::numeric_limits<unsigned>::max();
     Route bestRoute;
     Route route(numOfCities_);
@@ -57,25 +150,78 @@ Solution TSP::bruteForce() const
     return {shortestDistance, bestRoute};
 }
 
-unsigned TSP::calcCostOfRoute(const Route& route) const
+void TSP::changeWeights(const std::vector<WeightChange>& changes)
 {
-    unsigned cost = 0U;
-    for (unsigned i = 0; i < route.size() - 1; ++i)
+    for (const auto& change : changes)
     {
-        cost += graph_.getWeightOfEdge(route[i], route[i + 1]);
+        if (!edgeExists(change.from_, change.to_) || change.weight_ == 0U)
+        {
+            throw std::runtime_error { " * Invalid weight change of edge from "
+                    + std::to_string(change.from_) + " to " + std::to_string(change.to_)
+                    + " * " };
+        }
     }
-    cost += graph_.getWeightOfEdge(route.front(), route.back());
-    return cost;
+
+    for (const auto& change : changes)
+    {
+        sumOfCosts_ += change.weight_;
+        sumOfCosts_ -= distances_(change.from_, change.to_);
+        distances_.setWeight(change.from_, change.to_, change.weight_);
+    }
+
+    // Replicas are copied again from the new weights when an island needs them
+    std::lock_guard<std::mutex> lock(m_);
+    replicas_.clear();
+}
+
+const DistanceMatrix& TSP::getDistances() const
+{
+    return distances_;
+}
+
+unsigned TSP::calcCostOfRoute(const Route& route) const
+{
+    return GeneticPolicies::MatrixDistance { distances_ }(route);
 }
 
 Solution TSP::genetic_multi(const unsigned populationSize, const long double mutationProbability,
-        const unsigned numOfGenerations) const
+        const unsigned numOfGenerations,
+        const unsigned numOfThreads /*= hardware_concurrency()*/) const
+{
+    RandomGenerator randomGen { nextSeed() };
+    return genetic_multi(populationSize, mutationProbability, numOfGenerations, numOfThreads,
+            randomGen);
+}
+
+Solution TSP::genetic_multi(const unsigned populationSize, const long double mutationProbability,
+        const unsigned numOfGenerations, const unsigned numOfThreads,
+        RandomGenerator& randomGen,
+        const Affinity::PlacementPolicy& placementPolicy /*= Affinity::PlacementPolicy()*/) const
 {
+    static const Affinity::Topology topology { Affinity::detectTopology() };
+    const unsigned numOfIslands = std::max(numOfThreads, 1U);
+    const std::vector<unsigned> cpus { Affinity::assignCpus(topology,
+            placementPolicy.placement_, numOfIslands) };
+    const bool replicate = placementPolicy.replicateDistances_ && topology.getNumOfNodes() > 1;
+
     std::vector<std::future<Solution>> futures;
-    for (auto i = 0U; i < std::thread::hardware_concurrency(); ++i)
+    for (auto i = 0U; i < numOfIslands; ++i)
     {
+        const std::uint64_t islandSeed = randomGen();
+        const int cpu = cpus.empty() ? -1 : static_cast<int>(cpus[i]);
         futures.emplace_back(std::async(std::launch::async,
-                [&](){return genetic(populationSize, mutationProbability, numOfGenerations);}));
+                [=]()
+                {
+                    if (cpu >= 0)
+                    {
+                        Affinity::pinCurrentThreadToCpu(cpu);
+                    }
+                    const DistanceMatrix& distances { replicate && cpu >= 0 ?
+                            getReplica(topology.nodeOf(cpu)) : distances_ };
+                    RandomGenerator islandGen { islandSeed };
+                    return evolve(distances, populationSize, mutationProbability,
+                            numOfGenerations, islandGen, Population(0));
+                }));
     }
 
     Population finalPopulation;
@@ -84,127 +230,127 @@ Solution TSP::genetic_multi(const unsigned populationSize, const long double mut
         finalPopulation.emplace_back(std::move(f.get().route_));
     }
 
-    return genetic(finalPopulation.size(), mutationProbability, numOfGenerations, finalPopulation);
+    return genetic(finalPopulation.size(), mutationProbability, numOfGenerations, randomGen,
+            finalPopulation);
 }
 
-Solution TSP::genetic(const unsigned populationSize, const long double mutationProbability,
-        const unsigned numOfGenerations, Population pop /*= Population(0)*/) const
+Solution TSP::genetic_steady(const unsigned populationSize,
+        const long double mutationProbability, const unsigned numOfGenerations,
+        const unsigned numOfThreads /*= hardware_concurrency()*/) const
 {
-    Population population;
-    if (pop.empty())
-    {
-        population = std::move(generateInitPopulation(populationSize));
-    }
-    else
-    {
-        population = std::move(pop);
-    }
-    std::uniform_real_distribution<long double> distr(0, 1);
+    RandomGenerator randomGen { nextSeed() };
+    return genetic_steady(populationSize, mutationProbability, numOfGenerations, numOfThreads,
+            randomGen);
+}
 
-    for (auto i = 0U; i < numOfGenerations; ++i)
+Solution TSP::genetic_steady(const unsigned populationSize,
+        const long double mutationProbability, const unsigned numOfGenerations,
+        const unsigned numOfThreads, RandomGenerator& randomGen) const
+{
+    const GeneticParameters parameters { populationSize, mutationProbability, numOfGenerations };
+    if (fitsCityType<std::uint16_t>(numOfCities_))
     {
-        std::partial_sort(population.begin(), population.begin() + populationSize / 2,
-                population.end(), [this](const Route& lhs, const Route& rhs)
-                {
-                    return calcCostOfRoute(lhs) < calcCostOfRoute(rhs);
-                });
-
-        for (auto j = populationSize / 2; j < populationSize; ++j)
-        {
-            Parents p = pickParents(population);
-            Route offspring { createOffspring(std::move(p.first), std::move(p.second)) };
-            if (distr(randomGen_) <= mutationProbability)
-            {
-                mutate(offspring);
-            }
-            population[j] = std::move(offspring);
-        }
+        SteadyStateEngine<GeneticPolicies::OrderCrossover, GeneticPolicies::SwapMutation,
+                GeneticPolicies::MatrixDistance, CompactRoute> engine(
+                GeneticPolicies::MatrixDistance { distances_ }, numOfCities_, parameters,
+                numOfThreads);
+        return runOnRoutes(engine, randomGen, Population(0));
     }
-    Route best { getFittest(population) };
-    return {calcCostOfRoute(best), best};
+    SteadyStateEngine<GeneticPolicies::OrderCrossover, GeneticPolicies::SwapMutation,
+            GeneticPolicies::MatrixDistance> engine(GeneticPolicies::MatrixDistance { distances_ },
+            numOfCities_, parameters, numOfThreads);
+    return engine.run(randomGen);
 }
 
-Population TSP::generateInitPopulation(const unsigned populationSize) const
+Solution TSP::genetic_adaptive(const unsigned populationSize,
+        const unsigned numOfGenerations) const
 {
-    Population population(populationSize);
-    Route route(numOfCities_);
-    std::iota(route.begin(), route.end(), 0);
-
-    for (unsigned i = 0; i < populationSize; ++i)
-    {
-        std::shuffle(route.begin(), route.end(), randomGen_);
-        population[i] = route;
-    }
-    return population;
+    RandomGenerator randomGen { nextSeed() };
+    return genetic_adaptive(populationSize, numOfGenerations, randomGen);
 }
 
-Parents TSP::pickParents(const Population& population) const
+Solution TSP::genetic_adaptive(const unsigned populationSize, const unsigned numOfGenerations,
+        RandomGenerator& randomGen) const
 {
-    const unsigned alphaSize = population.size() > 4? population.size() / 2 : 3;
-    std::uniform_int_distribution<unsigned> distr(0, alphaSize - 1);
+    return genetic_adaptive(populationSize, numOfGenerations, randomGen, AdaptiveParameters());
+}
 
-    unsigned parent_a = distr(randomGen_);
-    unsigned parent_b = distr(randomGen_);
-    while (parent_a == parent_b)
+Solution TSP::genetic_adaptive(const unsigned populationSize, const unsigned numOfGenerations,
+        RandomGenerator& randomGen, const AdaptiveParameters& adaptive) const
+{
+    const GeneticParameters parameters { populationSize, 0.0, numOfGenerations };
+    if (fitsCityType<std::uint16_t>(numOfCities_))
     {
-        parent_b = distr(randomGen_);
+        AdaptiveEngine<GeneticPolicies::MatrixDistance, CompactRoute> engine(
+                GeneticPolicies::MatrixDistance { distances_ }, numOfCities_, parameters,
+                adaptive);
+        return runOnRoutes(engine, randomGen, Population(0));
     }
-
-    return std::make_pair(population[parent_a], population[parent_b]);
+    AdaptiveEngine<GeneticPolicies::MatrixDistance> engine(
+            GeneticPolicies::MatrixDistance { distances_ }, numOfCities_, parameters, adaptive);
+    return engine.run(randomGen);
 }
 
-Route TSP::createOffspring(Route parent_a, Route parent_b) const
+Solution TSP::genetic(const unsigned populationSize, const long double mutationProbability,
+        const unsigned numOfGenerations, Population pop /*= Population(0)*/) const
 {
-    std::uniform_int_distribution<unsigned> distr(0, parent_a.size() - 1);
-    Route offspring(parent_a.size(), -1);
+    RandomGenerator randomGen { nextSeed() };
+    return genetic(populationSize, mutationProbability, numOfGenerations, randomGen,
+            std::move(pop));
+}
 
-    const unsigned pivot_a = distr(randomGen_);
-    unsigned pivot_b = distr(randomGen_);
-    while (pivot_b < pivot_a)
-    {
-        pivot_b = distr(randomGen_);
-    }
+Solution TSP::genetic(const unsigned populationSize, const long double mutationProbability,
+        const unsigned numOfGenerations, RandomGenerator& randomGen,
+        Population pop /*= Population(0)*/) const
+{
+    return evolve(distances_, populationSize, mutationProbability, numOfGenerations, randomGen,
+            std::move(pop));
+}
 
-    for (auto i = pivot_a; i <= pivot_b; ++i)
+Solution TSP::evolve(const DistanceMatrix& distances, const unsigned populationSize,
+        const long double mutationProbability, const unsigned numOfGenerations,
+        RandomGenerator& randomGen, Population pop) const
+{
+    const GeneticParameters parameters { populationSize, mutationProbability, numOfGenerations };
+    if (SmallInstances::supportsGenetic(numOfCities_))
     {
-        offspring[i] = parent_a[i];
+        return SmallInstances::genetic(distances, parameters, randomGen, pop);
     }
-    for (auto i = 0U; i < offspring.size(); ++i)
+    if (fitsCityType<std::uint16_t>(numOfCities_))
     {
-        if ((i < pivot_a) || (i > pivot_b))
-        {
-            unsigned j = 0;
-            while (routeContainsCity(offspring, parent_b[j]))
-            {
-                ++j;
-            }
-            offspring[i] = parent_b[j];
-        }
+        DefaultGeneticEngineOf<std::uint16_t> engine(GeneticPolicies::MatrixDistance { distances },
+                numOfCities_, parameters);
+        return runOnRoutes(engine, randomGen, pop);
     }
-    return offspring;
+    DefaultGeneticEngine engine(GeneticPolicies::MatrixDistance { distances }, numOfCities_,
+            parameters);
+    return engine.run(randomGen, std::move(pop));
 }
 
-void TSP::mutate(Route& route) const
+Population TSP::generateInitPopulation(const unsigned populationSize,
+        RandomGenerator& randomGen) const
 {
-    std::uniform_int_distribution<unsigned> distr(0, route.size() - 1);
-    std::swap(route[distr(randomGen_)], route[distr(randomGen_)]);
-}
-
-bool TSP::routeContainsCity(const Route& route, const unsigned city) const
-{
-    return std::find(route.begin(), route.end(), city) != route.end();
-}
+    Population population(populationSize);
+    Route route(numOfCities_);
+    std::iota(route.begin(), route.end(), 0);
 
-Route TSP::getFittest(const Population& population) const
-{
-    return *std::min_element(population.begin(), population.end(),
-            [this](const Route& lhs, const Route& rhs)
-            {
-                return calcCostOfRoute(lhs) < calcCostOfRoute(rhs);
-            });
+    for (unsigned i = 0; i < populationSize; ++i)
+    {
+        std::shuffle(route.begin(), route.end(), randomGen);
+        population[i] = route;
+    }
+    return population;
 }
 
 void TSP::printGraph() const
 {
-    std::cout << graph_ << std::endl;
+    for (auto from = 0U; from < numOfCities_; ++from)
+    {
+        for (auto to = 0U; to < numOfCities_; ++to)
+        {
+            std::cout << std::setw(10) << distances_(from, to);
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
 }
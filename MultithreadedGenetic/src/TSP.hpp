@@ -1,23 +1,50 @@
 #ifndef TSP_HPP_
 #define TSP_HPP_
 
+#include "Affinity.hpp"
+#include "DistanceMatrix.hpp"
 #include "UndirectedGraph.hpp"
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 using Graph = UndirectedGraph;
-using Route = std::vector<unsigned>;
-using Parents = std::pair<Route, Route>;
-using Population = std::vector<Route>;
+// Routes are generic over the city index type, solvers narrow it to the smallest type
+// that holds every city of the instance (see GeneticEngine.hpp)
+template<typename City>
+using BasicRoute = std::vector<City>;
+template<typename City>
+using BasicPopulation = std::vector<BasicRoute<City>>;
 
-struct Solution
+using Route = BasicRoute<unsigned>;
+using Population = BasicPopulation<unsigned>;
+using CompactRoute = BasicRoute<std::uint16_t>;
+using RandomGenerator = std::mt19937_64;
+
+template<typename R>
+struct BasicSolution
 {
     unsigned cost_ = 0U;
-    Route route_;
+    R route_;
+};
+
+using Solution = BasicSolution<Route>;
+
+struct AdaptiveParameters;
+
+// New weight of the undirected edge between two cities
+struct WeightChange
+{
+    unsigned from_ = 0U;
+    unsigned to_ = 0U;
+    unsigned weight_ = 0U;
 };
 
 class TSP
@@ -28,37 +55,90 @@ public:
     TSP(const unsigned numOfCities, const unsigned minCost,
             const unsigned maxCost);
     TSP(std::string pathToFile);
+    // Instance of given weights, every pair of cities gets an edge of positive weight
+    explicit TSP(DistanceMatrix distances);
     TSP(TSP&&) = default;
     ~TSP() = default;
 
-    unsigned getSumOfCosts() const;
+    // Of every edge, wide enough for the largest instances
+    unsigned long long getSumOfCosts() const;
     unsigned getNumOfCities() const;
+    // Throws std::runtime_error if there's no edge between the cities
     unsigned getCostBetweenCities(const unsigned from, const unsigned to) const;
 
+    // Reseeds the generator every solver call draws its own seed from
+    void seed(const std::uint64_t seed);
+
     Solution bruteForce() const;
     Solution genetic(const unsigned populationSize, const long double mutationProbability,
             const unsigned numOfGenerations, Population pop = Population(0)) const;
+    Solution genetic(const unsigned populationSize, const long double mutationProbability,
+            const unsigned numOfGenerations, RandomGenerator& randomGen,
+            Population pop = Population(0)) const;
 
     Solution genetic_multi(const unsigned populationSize, const long double mutationProbability,
+            const unsigned numOfGenerations,
+            const unsigned numOfThreads = std::thread::hardware_concurrency()) const;
+    // Islands are pinned according to placement policy. They allocate their populations
+    // after pinning, so on NUMA machines the populations live in the island's node.
+    Solution genetic_multi(const unsigned populationSize, const long double mutationProbability,
+            const unsigned numOfGenerations, const unsigned numOfThreads,
+            RandomGenerator& randomGen,
+            const Affinity::PlacementPolicy& placementPolicy = Affinity::PlacementPolicy()) const;
+
+    // Steady-state GA: numOfThreads workers breed into one shared population,
+    // see SteadyStateEngine.hpp. Reproducible for a given seed only with one thread.
+    Solution genetic_steady(const unsigned populationSize,
+            const long double mutationProbability, const unsigned numOfGenerations,
+            const unsigned numOfThreads = std::thread::hardware_concurrency()) const;
+    Solution genetic_steady(const unsigned populationSize,
+            const long double mutationProbability, const unsigned numOfGenerations,
+            const unsigned numOfThreads, RandomGenerator& randomGen) const;
+
+    // GA adapting its operators, mutation rate and population size while it runs,
+    // see AdaptiveEngine.hpp. populationSize is only the initial size. Reproducible for
+    // a given seed, operators are credited per child.
+    Solution genetic_adaptive(const unsigned populationSize,
             const unsigned numOfGenerations) const;
+    Solution genetic_adaptive(const unsigned populationSize, const unsigned numOfGenerations,
+            RandomGenerator& randomGen) const;
+    // E.g. with perTime_, which credits operators per CPU time but isn't reproducible
+    Solution genetic_adaptive(const unsigned populationSize, const unsigned numOfGenerations,
+            RandomGenerator& randomGen, const AdaptiveParameters& adaptive) const;
+
+    // Sets new weights of existing edges, throws std::runtime_error and changes nothing
+    // if any of them is invalid. Must not run concurrently with a solver.
+    void changeWeights(const std::vector<WeightChange>& changes);
 
     void printGraph() const;
-    Route createOffspring(Route parent_a, Route parent_b) const;
+
+    const DistanceMatrix& getDistances() const;
+    unsigned calcCostOfRoute(const Route& route) const;
+    Population generateInitPopulation(const unsigned populationSize,
+            RandomGenerator& randomGen) const;
 
 private:
-    const Graph graph_;
+    // The only copy of the weights, graphs an instance is read from aren't kept
+    DistanceMatrix distances_;
     const unsigned numOfCities_ = 0U;
-    const unsigned sumOfCosts_ = 0U;
+    unsigned long long sumOfCosts_ = 0U;
     mutable std::mt19937_64 randomGen_{std::random_device{}()};
     mutable std::mutex m_;
-    unsigned calcCostOfRoute(const Route& route) const;
-
-    Population generateInitPopulation(const unsigned populationSize) const;
-    Parents pickParents(const Population& population) const;
+    struct Replica
+    {
+        std::once_flag copied_;
+        std::unique_ptr<const DistanceMatrix> distances_;
+    };
+    // Per NUMA node copies of distances_, created by the first island pinned to the node
+    mutable std::map<unsigned, Replica> replicas_;
 
-    void mutate(Route& route) const;
-    bool routeContainsCity(const Route& route, const unsigned city) const;
-    Route getFittest(const Population& population) const;
+    // Missing edges weigh 0 in distances_
+    bool edgeExists(const unsigned from, const unsigned to) const;
+    std::uint64_t nextSeed() const;
+    const DistanceMatrix& getReplica(const unsigned node) const;
+    Solution evolve(const DistanceMatrix& distances, const unsigned populationSize,
+            const long double mutationProbability, const unsigned numOfGenerations,
+            RandomGenerator& randomGen, Population pop) const;
 };
 
 #endif /* TSP_HPP_ */
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -29,6 +30,16 @@ TEST_F(TravellingSalesmanProblemFixture, canBeCreatedFromFile)
     ASSERT_EQ(4, tsp_->getCostBetweenCities(1, 2));
 }
 
+TEST(TravellingSalesmanProblem, sumsCostsOfMatrixWithoutOverflow)
+{
+    const unsigned big = 3000000000U;
+    const TSP tsp(DistanceMatrix(3, { 0, big, big, big, 0, big, big, big, 0 }));
+    ASSERT_EQ(3ULL * big, tsp.getSumOfCosts());
+    ASSERT_EQ(big, tsp.getCostBetweenCities(2, 0));
+    ASSERT_THROW(tsp.getCostBetweenCities(1, 1), std::runtime_error);
+    ASSERT_THROW(TSP(DistanceMatrix(2, { 0, 1, 2, 0 })), std::runtime_error);
+}
+
 TEST_F(TravellingSalesmanProblemFixture, findsOptimalPath_bruteForce)
 {
     Solution s = tsp_->bruteForce();
@@ -45,3 +56,35 @@ TEST_F(TravellingSalesmanProblemFixture, findsAPath_genetic)
     std::sort(s.route_.begin(), s.route_.end());
     ASSERT_TRUE(test == s.route_);
 }
+
+TEST_F(TravellingSalesmanProblemFixture, findsAPath_genetic_multi_singleThread)
+{
+    Solution s = tsp_->genetic_multi(10, 0.01, 10, 1);
+    Route test(s.route_.size());
+    std::iota(test.begin(), test.end(), 0);
+    std::sort(s.route_.begin(), s.route_.end());
+    ASSERT_EQ(4, test.size());
+    ASSERT_TRUE(test == s.route_);
+}
+
+TEST_F(TravellingSalesmanProblemFixture, isReproducibleForGivenSeed)
+{
+    RandomGenerator first { 7 };
+    RandomGenerator second { 7 };
+    Solution a = tsp_->genetic(10, 0.5, 10, first);
+    Solution b = tsp_->genetic(10, 0.5, 10, second);
+    ASSERT_EQ(a.cost_, b.cost_);
+    ASSERT_TRUE(a.route_ == b.route_);
+}
+
+TEST_F(TravellingSalesmanProblemFixture, findsAPath_genetic_multi_pinned)
+{
+    RandomGenerator randomGen { 3 };
+    Affinity::PlacementPolicy policy;
+    policy.placement_ = Affinity::Placement::Compact;
+    policy.replicateDistances_ = true;
+    Solution s = tsp_->genetic_multi(10, 0.01, 10, 2, randomGen, policy);
+    ASSERT_EQ(s.cost_, tsp_->calcCostOfRoute(s.route_));
+    std::sort(s.route_.begin(), s.route_.end());
+    ASSERT_THAT(s.route_, ElementsAre(0, 1, 2, 3));
+}
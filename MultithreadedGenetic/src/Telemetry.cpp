@@ -0,0 +1,217 @@
+#include "Telemetry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <unordered_set>
+
+namespace Telemetry
+{
+
+namespace
+{
+
+std::mutex registryMutex;
+std::vector<std::shared_ptr<Recorder>> recorders;
+std::atomic<unsigned> epoch { 0U };
+
+std::mutex streamMutex;
+std::atomic<std::ostream*> stream { nullptr };
+std::atomic<unsigned> streamEvery { 0U };
+
+void writeGenerationsHeader(std::ostream& os)
+{
+    os << "thread,run,generation,best,mean,worst,diversity,improvements\n";
+}
+
+void writeGenerationRow(std::ostream& os, const GenerationStats& g)
+{
+    os << g.thread_ << ',' << g.run_ << ',' << g.generation_ << ',' << g.bestCost_ << ','
+            << g.meanCost_ << ',' << g.worstCost_ << ',' << g.diversity_ << ','
+            << g.improvements_ << '\n';
+}
+
+}
+
+const char* phaseName(const Phase phase)
+{
+    switch (phase)
+    {
+    case Phase::Selection: return "selection";
+    case Phase::Crossover: return "crossover";
+    case Phase::Mutation: return "mutation";
+    case Phase::Evaluation: return "evaluation";
+    case Phase::Sorting: return "sorting";
+    }
+    return "unknown";
+}
+
+Recorder::Recorder(const unsigned thread)
+        : thread_ { thread }
+{}
+
+void Recorder::addPhase(const Phase phase, const std::uint64_t nanoseconds)
+{
+    auto& stats = phases_[static_cast<unsigned>(phase)];
+    ++stats.calls_;
+    stats.nanoseconds_ += nanoseconds;
+}
+
+void Recorder::beginRun()
+{
+    ++run_;
+    generation_ = 0U;
+}
+
+void Recorder::addGeneration(const std::vector<unsigned>& costs, const unsigned improvements)
+{
+    if (costs.empty())
+    {
+        return;
+    }
+    GenerationStats stats;
+    stats.thread_ = thread_;
+    stats.run_ = run_;
+    stats.generation_ = generation_++;
+    const auto minMax = std::minmax_element(costs.begin(), costs.end());
+    stats.bestCost_ = *minMax.first;
+    stats.worstCost_ = *minMax.second;
+    stats.meanCost_ = std::accumulate(costs.begin(), costs.end(), 0.0L) / costs.size();
+    const std::unordered_set<unsigned> distinct(costs.begin(), costs.end());
+    stats.diversity_ = static_cast<long double>(distinct.size()) / costs.size();
+    stats.improvements_ = improvements;
+    generations_.push_back(stats);
+
+    std::ostream* os = stream.load(std::memory_order_relaxed);
+    const unsigned every = streamEvery.load(std::memory_order_relaxed);
+    if (os && every && stats.generation_ % every == 0)
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        writeGenerationRow(*os, stats);
+    }
+}
+
+unsigned Recorder::getThread() const
+{
+    return thread_;
+}
+
+const std::array<PhaseStats, NUM_OF_PHASES>& Recorder::getPhases() const
+{
+    return phases_;
+}
+
+const std::vector<GenerationStats>& Recorder::getGenerations() const
+{
+    return generations_;
+}
+
+Recorder& local()
+{
+    thread_local std::shared_ptr<Recorder> recorder;
+    thread_local unsigned recorderEpoch = 0U;
+    const unsigned currentEpoch = epoch.load(std::memory_order_acquire);
+    if (!recorder || recorderEpoch != currentEpoch)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        recorder = std::make_shared<Recorder>(recorders.size());
+        recorders.push_back(recorder);
+        recorderEpoch = currentEpoch;
+    }
+    return *recorder;
+}
+
+ScopedTimer::ScopedTimer(const Phase phase)
+        : phase_ { phase }, start_ { std::chrono::steady_clock::now() }
+{}
+
+ScopedTimer::~ScopedTimer()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - start_;
+    local().addPhase(phase_,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+Report collect()
+{
+    Report report;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& recorder : recorders)
+    {
+        for (auto i = 0U; i < NUM_OF_PHASES; ++i)
+        {
+            report.phases_[i].calls_ += recorder->getPhases()[i].calls_;
+            report.phases_[i].nanoseconds_ += recorder->getPhases()[i].nanoseconds_;
+        }
+        const auto& generations = recorder->getGenerations();
+        report.generations_.insert(report.generations_.end(), generations.begin(),
+                generations.end());
+    }
+    return report;
+}
+
+void reset()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    recorders.clear();
+    ++epoch;
+}
+
+void streamTo(std::ostream* os, const unsigned everyNGenerations)
+{
+    std::lock_guard<std::mutex> lock(streamMutex);
+    if (os && everyNGenerations)
+    {
+        writeGenerationsHeader(*os);
+    }
+    streamEvery = everyNGenerations;
+    stream = os;
+}
+
+void writePhasesCsv(std::ostream& os, const Report& report)
+{
+    os << "phase,calls,nanoseconds,ns_per_call\n";
+    for (auto i = 0U; i < NUM_OF_PHASES; ++i)
+    {
+        const auto& stats = report.phases_[i];
+        os << phaseName(static_cast<Phase>(i)) << ',' << stats.calls_ << ','
+                << stats.nanoseconds_ << ','
+                << (stats.calls_ ? static_cast<long double>(stats.nanoseconds_) / stats.calls_ : 0)
+                << '\n';
+    }
+}
+
+void writeGenerationsCsv(std::ostream& os, const Report& report)
+{
+    writeGenerationsHeader(os);
+    for (const auto& g : report.generations_)
+    {
+        writeGenerationRow(os, g);
+    }
+}
+
+void writeJson(std::ostream& os, const Report& report)
+{
+    os << "{\"phases\":{";
+    for (auto i = 0U; i < NUM_OF_PHASES; ++i)
+    {
+        const auto& stats = report.phases_[i];
+        os << (i ? "," : "") << '"' << phaseName(static_cast<Phase>(i)) << "\":{\"calls\":"
+                << stats.calls_ << ",\"nanoseconds\":" << stats.nanoseconds_ << '}';
+    }
+    os << "},\"generations\":[";
+    for (auto i = 0U; i < report.generations_.size(); ++i)
+    {
+        const auto& g = report.generations_[i];
+        os << (i ? "," : "") << "{\"thread\":" << g.thread_ << ",\"run\":" << g.run_
+                << ",\"generation\":" << g.generation_ << ",\"best\":" << g.bestCost_
+                << ",\"mean\":" << g.meanCost_ << ",\"worst\":" << g.worstCost_
+                << ",\"diversity\":" << g.diversity_ << ",\"improvements\":"
+                << g.improvements_ << '}';
+    }
+    os << "]}\n";
+}
+
+}
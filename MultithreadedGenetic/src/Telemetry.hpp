@@ -0,0 +1,116 @@
+#ifndef TELEMETRY_HPP_
+#define TELEMETRY_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+/*
+ * Hot-path counters, timers and per-generation statistics of the genetic solvers.
+ * Instrumentation points use the TELEMETRY_* macros, which compile to nothing unless
+ * the project is built with -DZWSISK_TELEMETRY.
+ *
+ * Every thread records into its own Recorder, so nothing is shared on the hot path.
+ * Recorders outlive their threads and are merged by collect() once the run is over.
+ */
+namespace Telemetry
+{
+
+enum class Phase : unsigned
+{
+    Selection, Crossover, Mutation, Evaluation, Sorting
+};
+constexpr unsigned NUM_OF_PHASES = 5;
+
+const char* phaseName(const Phase phase);
+
+struct PhaseStats
+{
+    std::uint64_t calls_ = 0U;
+    std::uint64_t nanoseconds_ = 0U;
+};
+
+struct GenerationStats
+{
+    unsigned thread_ = 0U;
+    unsigned run_ = 0U;
+    unsigned generation_ = 0U;
+    unsigned bestCost_ = 0U;
+    long double meanCost_ = 0.0;
+    unsigned worstCost_ = 0U;
+    // Fraction of distinct costs in the population, cheap proxy for distinct tours
+    long double diversity_ = 0.0;
+    // Offspring cheaper than the individual they replaced
+    unsigned improvements_ = 0U;
+};
+
+struct Report
+{
+    std::array<PhaseStats, NUM_OF_PHASES> phases_;
+    std::vector<GenerationStats> generations_;
+};
+
+class Recorder
+{
+public:
+    explicit Recorder(const unsigned thread);
+
+    void addPhase(const Phase phase, const std::uint64_t nanoseconds);
+    void beginRun();
+    void addGeneration(const std::vector<unsigned>& costs, const unsigned improvements);
+
+    unsigned getThread() const;
+    const std::array<PhaseStats, NUM_OF_PHASES>& getPhases() const;
+    const std::vector<GenerationStats>& getGenerations() const;
+
+private:
+    const unsigned thread_;
+    unsigned run_ = 0U;
+    unsigned generation_ = 0U;
+    std::array<PhaseStats, NUM_OF_PHASES> phases_;
+    std::vector<GenerationStats> generations_;
+};
+
+// Recorder of the calling thread, created on first use
+Recorder& local();
+
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const Phase phase);
+    ~ScopedTimer();
+
+private:
+    const Phase phase_;
+    const std::chrono::steady_clock::time_point start_;
+};
+
+// Merges all recorders. Call it when no solver is running.
+Report collect();
+void reset();
+
+// Streams every n-th generation of every thread as a CSV row, 0 or nullptr disables it
+void streamTo(std::ostream* os, const unsigned everyNGenerations);
+
+void writePhasesCsv(std::ostream& os, const Report& report);
+void writeGenerationsCsv(std::ostream& os, const Report& report);
+void writeJson(std::ostream& os, const Report& report);
+
+}
+
+#ifdef ZWSISK_TELEMETRY
+#define TELEMETRY_ENABLED 1
+#define TELEMETRY_SCOPE(phase) const Telemetry::ScopedTimer telemetryTimer { phase }
+#define TELEMETRY_BEGIN_RUN() Telemetry::local().beginRun()
+#define TELEMETRY_GENERATION(costs, improvements) \
+    Telemetry::local().addGeneration(costs, improvements)
+#else
+#define TELEMETRY_ENABLED 0
+#define TELEMETRY_SCOPE(phase)
+#define TELEMETRY_BEGIN_RUN()
+#define TELEMETRY_GENERATION(costs, improvements)
+#endif
+
+#endif /* TELEMETRY_HPP_ */
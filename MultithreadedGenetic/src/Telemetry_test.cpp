@@ -0,0 +1,55 @@
+#include "Telemetry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(TelemetryRecorder, computesGenerationStats)
+{
+    Telemetry::Recorder recorder(3);
+    recorder.beginRun();
+    recorder.addGeneration({10, 20, 20, 30}, 2);
+    recorder.addGeneration({10, 10, 10, 10}, 0);
+
+    const auto& generations = recorder.getGenerations();
+    ASSERT_EQ(2, generations.size());
+    ASSERT_EQ(3, generations[0].thread_);
+    ASSERT_EQ(0, generations[0].generation_);
+    ASSERT_EQ(10, generations[0].bestCost_);
+    ASSERT_EQ(30, generations[0].worstCost_);
+    ASSERT_DOUBLE_EQ(20.0, generations[0].meanCost_);
+    ASSERT_DOUBLE_EQ(0.75, generations[0].diversity_);
+    ASSERT_EQ(2, generations[0].improvements_);
+    ASSERT_EQ(1, generations[1].generation_);
+    ASSERT_DOUBLE_EQ(0.25, generations[1].diversity_);
+}
+
+TEST(TelemetryRecorder, accumulatesPhases)
+{
+    Telemetry::Recorder recorder(0);
+    recorder.addPhase(Telemetry::Phase::Crossover, 100);
+    recorder.addPhase(Telemetry::Phase::Crossover, 50);
+    const auto& crossover = recorder.getPhases()[static_cast<unsigned>(Telemetry::Phase::Crossover)];
+    ASSERT_EQ(2, crossover.calls_);
+    ASSERT_EQ(150, crossover.nanoseconds_);
+}
+
+TEST(TelemetryReport, collectsThreadRecordersAndWritesCsv)
+{
+    Telemetry::reset();
+    Telemetry::local().addPhase(Telemetry::Phase::Sorting, 40);
+    Telemetry::local().addGeneration({5, 7}, 1);
+    const Telemetry::Report report = Telemetry::collect();
+    Telemetry::reset();
+
+    ASSERT_EQ(1, report.generations_.size());
+    std::stringstream ss;
+    Telemetry::writeGenerationsCsv(ss, report);
+    ASSERT_EQ("thread,run,generation,best,mean,worst,diversity,improvements\n"
+            "0,0,0,5,6,7,1,1\n", ss.str());
+    ss.str("");
+    Telemetry::writePhasesCsv(ss, report);
+    ASSERT_NE(std::string::npos, ss.str().find("sorting,1,40,40\n"));
+}
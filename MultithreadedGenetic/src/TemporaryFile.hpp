@@ -0,0 +1,34 @@
+#ifndef TEMPORARYFILE_HPP_
+#define TEMPORARYFILE_HPP_
+
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+// Path in /tmp of a file belonging to the test process, the file is removed with the object
+class TemporaryFile
+{
+public:
+    explicit TemporaryFile(const std::string& name)
+            : path_ { "/tmp/" + name + "_" + std::to_string(getpid()) + ".bin" }
+    {}
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    ~TemporaryFile()
+    {
+        std::remove(path_.c_str());
+    }
+
+    const std::string& getPath() const
+    {
+        return path_;
+    }
+
+private:
+    const std::string path_;
+};
+
+#endif /* TEMPORARYFILE_HPP_ */
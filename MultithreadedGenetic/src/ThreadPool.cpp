@@ -0,0 +1,58 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(const unsigned numOfThreads)
+{
+    for (auto i = 0U; i < std::max(numOfThreads, 1U); ++i)
+    {
+        workers_.emplace_back([this](){work();});
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::getNumOfThreads() const
+{
+    return workers_.size();
+}
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            cv_.wait(lock, [this](){return stopping_ || !tasks_.empty();});
+            if (tasks_.empty())
+            {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
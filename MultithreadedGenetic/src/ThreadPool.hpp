@@ -0,0 +1,49 @@
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Fixed set of worker threads executing submitted tasks in FIFO order.
+ * Destructor finishes all queued tasks before joining the workers.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(const unsigned numOfThreads = std::thread::hardware_concurrency());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    template<typename Function>
+    std::future<typename std::result_of<Function()>::type> submit(Function&& f)
+    {
+        using Result = typename std::result_of<Function()>::type;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(f));
+        std::future<Result> result { task->get_future() };
+        enqueue([task](){(*task)();});
+        return result;
+    }
+
+    unsigned getNumOfThreads() const;
+
+private:
+    void enqueue(std::function<void()> task);
+    void work();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+#endif /* THREADPOOL_HPP_ */
@@ -1,14 +1,122 @@
+#include "BatchSolver.hpp"
+#include "InstanceGenerator.hpp"
+#include "ProcessIslands.hpp"
 #include "ProjectUtilities.hpp"
+#include "QualityHarness.hpp"
+#include "SolverServer.hpp"
+#include "Telemetry.hpp"
+#include "ThreadPool.hpp"
 #include "TSP.hpp"
 #include "UndirectedGraph.hpp"
 
+#include <csignal>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 using namespace ProjectUtilities;
 
 int main(int argc, char **argv)
 {
+    const std::string mode { argc > 1 ? argv[1] : "" };
+    if (mode == "--test")
+    {
+        ::testing::InitGoogleTest(&argc, argv);
+        return RUN_ALL_TESTS();
+    }
+    if (mode == "--benchmark")
+    {
+        ::benchmark::Initialize(&argc, argv);
+        ::benchmark::RunSpecifiedBenchmarks();
+        return 0;
+    }
+    if (mode == "--quality" && argc > 2)
+    {
+        QualityHarness::Settings settings;
+        if (argc > 3)
+        {
+            settings.numOfSeeds_ = std::stoi(argv[3]);
+        }
+        const auto points = QualityHarness::run(QualityHarness::readInstances(argv[2]),
+                QualityHarness::defaultSolvers(150, 0.01, 4), settings);
+        QualityHarness::writeCsv(std::cout, points);
+        QualityHarness::writeTimeToTarget(std::cout, points, settings.targetGap_);
+        return 0;
+    }
+    if (mode == "--batch" && argc > 2)
+    {
+        std::ifstream manifest(argv[2]);
+        if (!manifest)
+        {
+            std::cerr << "Couldn't open " << argv[2] << std::endl;
+            return 1;
+        }
+        ThreadPool pool(argc > 3 ? std::stoi(argv[3]) : std::thread::hardware_concurrency());
+        const BatchSolver::Summary summary { BatchSolver::run(manifest,
+                BatchSolver::directoryOf(argv[2]), std::cout, BatchSolver::Settings(), pool) };
+        std::cerr << summary.numOfJobs_ << " instances (" << summary.numOfFailed_ << " failed) in "
+                << summary.seconds_ << "s, " << summary.jobsPerSecond() << " per second\n";
+        return summary.numOfFailed_ > 0;
+    }
+    if (mode == "--generate" && argc > 5)
+    {
+        InstanceGenerator::Settings settings;
+        settings.kind_ = InstanceGenerator::parseKind(argv[2]);
+        settings.numOfCities_ = std::stoi(argv[3]);
+        settings.seed_ = std::stoull(argv[4]);
+        if (argc > 6)
+        {
+            settings.numOfThreads_ = std::stoi(argv[6]);
+        }
+        InstanceGenerator::writeFile(argv[5], settings);
+        return 0;
+    }
+    if (mode == "--islands" && argc > 3)
+    {
+        ProcessIslands::Settings settings;
+        settings.matrixPath_ = argv[2];
+        settings.numOfProcesses_ = std::stoi(argv[3]);
+        if (argc > 4)
+        {
+            settings.numOfIslandsPerProcess_ = std::stoi(argv[4]);
+        }
+        const ProcessIslands::Summary summary { ProcessIslands::run(settings) };
+        std::cout << summary.best_.cost_ << std::endl;
+        std::cerr << summary.numOfFinishedIslands_ << " islands finished, "
+                << summary.numOfFailedProcesses_ << " processes failed, "
+                << summary.numOfMigrants_ << " migrants\n";
+        return summary.numOfFailedProcesses_ > 0;
+    }
+    if (mode == ProcessIslands::WORKER_MODE)
+    {
+        return ProcessIslands::runWorker({argv + 2, argv + argc});
+    }
+    if (mode == "--serve" && argc > 2)
+    {
+        // Blocked before any thread starts, so only sigwait below receives them
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        SolverServer::Settings settings;
+        settings.socketPath_ = argv[2];
+        if (argc > 3)
+        {
+            settings.numOfWorkers_ = std::stoi(argv[3]);
+        }
+        SolverServer server(settings);
+        server.start();
+        std::cerr << "Listening on " << settings.socketPath_ << std::endl;
+        int signal = 0;
+        sigwait(&signals, &signal);
+        server.stop();
+        return 0;
+    }
+
     constexpr unsigned NUM_OF_TESTS = 10;
     constexpr unsigned NUM_OF_CITIES = 25;
     constexpr unsigned MIN_COST = 1;
@@ -19,13 +127,21 @@ int main(int argc, char **argv)
 //    const TSP tsp(NUM_OF_CITIES, MIN_COST, MAX_COST);
 //    const TSP tsp("/home/dec/studia/sem6/zwsisk/graph_lower.txt");
     const TSP tsp("/home/dec/studia/sem6/zwsisk/swiss42.tsp");
+//    Telemetry::streamTo(&std::cerr, 50);
     Solution s = tsp.genetic(POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS);
     std::cout << "Koszt genetyczny: " << s.cost_ << std::endl;
 //    s = tsp.bruteForce();
 //    std::cout << "Koszt brute: " << s.cost_ << std::endl;
     s = tsp.genetic_multi(POPULATION_SIZE, MUTATION_PROBABILITY, NUM_OF_GENERATIONS);
     std::cout << "Koszt multi genetyczny: " << s.cost_ << std::endl;
+    s = tsp.genetic_adaptive(POPULATION_SIZE, NUM_OF_GENERATIONS);
+    std::cout << "Koszt adaptacyjny: " << s.cost_ << std::endl;
 //    printContainer(s.route_);
+#if TELEMETRY_ENABLED
+    std::ofstream telemetry("telemetry.json");
+    Telemetry::writeJson(telemetry, Telemetry::collect());
+    Telemetry::reset();
+#endif
 
     std::cout << "Sredni czas genetycznego dla " + std::to_string(tsp.getNumOfCities()) + " miast: "
             << measureAverageGeneticTime(NUM_OF_TESTS, tsp, POPULATION_SIZE, MUTATION_PROBABILITY,
@@ -43,7 +159,4 @@ int main(int argc, char **argv)
 //    std::cout << "Sredni blad genetycznego wzgledem multi genetycznego: "
 //            << measureGeneticErrorRelativeToMulti(NUM_OF_TESTS, tsp, POPULATION_SIZE,
 //                    MUTATION_PROBABILITY, NUM_OF_GENERATIONS) << std::endl;
-
-//    ::testing::InitGoogleTest(&argc, argv);
-//    return RUN_ALL_TESTS();
 }